@@ -8,8 +8,10 @@
 #define PROCESS_CONF_NUMEVENTS 32
 #define PROCESS_CONF_STATS     1
 
+#ifndef CLOCK_CONF_SECOND
 /** 32768/32 [Hz] */
 #define CLOCK_CONF_SECOND      1000
+#endif
 
 #define CONTIKI_PRINTF(...)
 
@@ -39,8 +39,11 @@
 #include "sys/process.h"
 
 #include "sys/timer.h"
+#include "sys/stimer.h"
 #include "sys/ctimer.h"
 #include "sys/etimer.h"
+#include "sys/tasklet.h"
+#include "sys/rtimer.h"
 
 #include "sys/pt.h"
 
@@ -0,0 +1,109 @@
+/**
+ * \addtogroup clock
+ * @{
+ */
+
+/**
+ * \file
+ * Stepping and slewing of the clock.
+ *
+ * clock_time() = raw + clock_step + slewed, the port supplies raw.  The
+ * etimers keep their times on clock_time() - clock_step, so a step of
+ * the clock is a single addition to clock_step and no timer has to be
+ * touched.  A slew is described by its start on the raw counter and the
+ * correction still to do, the part done so far is computed with a shift
+ * on every read and folded into slew_offset when a new slew starts.
+ *
+ * clock_time64() reads the state from interrupts and from the other core,
+ * so it is changed under clock_arch_lock().
+ */
+
+#include <assert.h>
+#include "contiki.h"
+
+#if CLOCK_CONF_ADJUST
+
+clock_time64_t clock_step;
+
+static clock_time64_t slew_offset;  /* corrections of finished slews */
+static clock_time64_t slew_start;   /* raw time of the start of the current slew */
+static int32_t slew_left;           /* correction of the current slew */
+
+/*---------------------------------------------------------------------------*/
+static int32_t slewed(clock_time64_t raw)
+/**
+ * Part of the current slew done at \a raw.
+ */
+{
+   clock_time64_t done;
+   uint32_t left;
+
+   if (slew_left == 0) {
+      return 0;
+   }
+   done = (raw - slew_start) >> CLOCK_CONF_SLEW_SHIFT;
+   left = (slew_left > 0) ? (uint32_t)slew_left : 0U - (uint32_t)slew_left;
+   if (done >= left) {
+      return slew_left;
+   }
+   return (slew_left > 0) ? (int32_t)done : -(int32_t)done;
+}
+/*---------------------------------------------------------------------------*/
+clock_time64_t clock_adjusted(clock_time64_t raw)
+{
+   return raw + clock_step + slew_offset + (clock_time64_t)(int64_t)slewed(raw);
+}
+/*---------------------------------------------------------------------------*/
+void clock_adjust(int32_t delta)
+{
+   clock_time64_t now;
+   uint32_t state;
+
+   assert( !CONTIKI_IN_ISR() );
+
+   state = clock_arch_lock();
+   now = clock_adjusted(clock_time64_raw());
+   if (delta < 0  &&  (clock_time64_t)(-(int64_t)delta) > now) {
+      /* clock_time64() must not wrap, CLOCK64_A_LT_B() relies on it */
+      delta = -(int32_t)now;
+   }
+   clock_step += (clock_time64_t)(int64_t)delta;
+   clock_arch_unlock(state);
+#if PROCESS_CONF_NOW_SNAPSHOT
+   /* the snapshot of the round moves with the clock */
+   PROCESS_CTX->now += (clock_time_t)delta;
+#endif
+   /* the etimer module reprograms the clock alarm for the new time base */
+   etimer_request_poll();
+}
+/*---------------------------------------------------------------------------*/
+void clock_slew(int32_t delta)
+{
+   clock_time64_t raw;
+   int32_t done;
+   uint32_t state;
+
+   assert( !CONTIKI_IN_ISR() );
+
+   state = clock_arch_lock();
+   raw = clock_time64_raw();
+   done = slewed(raw);
+   slew_offset += (clock_time64_t)(int64_t)done;
+   slew_left = slew_left - done + delta;
+   slew_start = raw;
+   clock_arch_unlock(state);
+}
+/*---------------------------------------------------------------------------*/
+int32_t clock_slew_remaining(void)
+{
+   uint32_t state = clock_arch_lock();
+   int32_t left = slew_left - slewed(clock_time64_raw());
+
+   clock_arch_unlock(state);
+   return left;
+}
+/*---------------------------------------------------------------------------*/
+
+#endif
+
+/** @} */
@@ -0,0 +1,119 @@
+/**
+ * \addtogroup clock
+ * @{
+ */
+
+/**
+ * \file
+ * Conversion of a microsecond counter to clock ticks and seconds, and of
+ * milliseconds to clock ticks.
+ *
+ * ticks = us * CLOCK_US_NUM / CLOCK_US_DEN.  Only the microseconds since
+ * the last call are multiplied by CLOCK_US_NUM, the remainder of the
+ * division is carried in \c frac, so the sum of the steps is exact.  The
+ * division by the constant CLOCK_US_DEN is a shift if it is a power of
+ * 2, else a multiplication by its 32 bit reciprocal with one correction
+ * step.  Neither needs a divide instruction, which the Cortex-M0+ lacks.
+ * A step too long for 32 bit takes the exact 64 bit path.
+ */
+
+#include "contiki-conf.h"
+#include "sys/clock.h"
+
+#if (CLOCK_US_DEN & (CLOCK_US_DEN - 1)) == 0
+   #define CLOCK_US_SHIFT  ((CLOCK_US_DEN >= 64) ? 6 : (CLOCK_US_DEN >= 32) ? 5 : (CLOCK_US_DEN >= 16) ? 4 : \
+                            (CLOCK_US_DEN >= 8) ? 3 : (CLOCK_US_DEN >= 4) ? 2 : (CLOCK_US_DEN >= 2) ? 1 : 0)
+#else
+   /* floor(2^32 / CLOCK_US_DEN), gives the quotient or one less */
+   #define CLOCK_US_RECIP  (0xffffffffUL / CLOCK_US_DEN)
+#endif
+
+/* longest step which fits the 32 bit accumulator */
+#define CLOCK_CONV_MAX_STEP  ((0xffffffffUL - (CLOCK_US_DEN - 1)) / CLOCK_US_NUM)
+
+#define US_PER_SECOND        1000000UL
+
+/* x / d for a constant d, see div_recip() */
+#define DIV_RECIP(x, d)      div_recip((x), (d), 0xffffffffUL / (d))
+
+/*---------------------------------------------------------------------------*/
+static inline uint32_t div_recip(uint32_t x, uint32_t d, uint32_t recip)
+/**
+ * \a x / \a d by the multiplication with \a recip = floor((2^32 - 1) / d).
+ * That gives the quotient or one less, one correction step.
+ */
+{
+   uint32_t q = (uint32_t)(((uint64_t)x * recip) >> 32);
+
+   if (x - q * d >= d) {
+      ++q;
+   }
+   return q;
+}
+/*---------------------------------------------------------------------------*/
+clock_time64_t clock_conv_ticks(struct clock_conv *c, uint64_t now_us)
+{
+   uint64_t step = now_us - c->us;
+
+   if (step <= CLOCK_CONV_MAX_STEP) {
+      uint32_t acc = (uint32_t)step * CLOCK_US_NUM + c->frac;
+      uint32_t q;
+
+#if (CLOCK_US_DEN & (CLOCK_US_DEN - 1)) == 0
+      q = acc >> CLOCK_US_SHIFT;
+#else
+      q = div_recip(acc, CLOCK_US_DEN, CLOCK_US_RECIP);
+#endif
+      c->frac = acc - q * CLOCK_US_DEN;
+      c->ticks += q;
+   }
+   else {
+      /* first call after a long pause, split to avoid overflow of us * CLOCK_US_NUM */
+      uint64_t q = now_us / CLOCK_US_DEN;
+      uint32_t r = (uint32_t)(now_us % CLOCK_US_DEN) * CLOCK_US_NUM;
+
+      c->ticks = q * CLOCK_US_NUM + r / CLOCK_US_DEN;
+      c->frac = r % CLOCK_US_DEN;
+   }
+   c->us = now_us;
+   return c->ticks;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t clock_conv_seconds(struct clock_conv_sec *c, uint64_t now_us)
+{
+   uint64_t step = now_us - c->us;
+
+   if (step <= 0xffffffffUL - (US_PER_SECOND - 1)) {
+      uint32_t acc = (uint32_t)step + c->frac;
+      uint32_t q = DIV_RECIP(acc, US_PER_SECOND);
+
+      c->frac = acc - q * US_PER_SECOND;
+      c->seconds += q;
+   }
+   else {
+      /* first call after a long pause */
+      c->seconds = (uint32_t)(now_us / US_PER_SECOND);
+      c->frac = (uint32_t)(now_us % US_PER_SECOND);
+   }
+   c->us = now_us;
+   return c->seconds;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t clock_ms_to_ticks(uint32_t ms)
+{
+#if CLOCK_MS_DEN == 1
+   return (clock_time_t)ms * CLOCK_MS_NUM;
+#elif (CLOCK_MS_DEN & (CLOCK_MS_DEN - 1)) == 0
+   /* shifts */
+   return (clock_time_t)((ms / CLOCK_MS_DEN) * CLOCK_MS_NUM + ((ms % CLOCK_MS_DEN) * CLOCK_MS_NUM + CLOCK_MS_DEN/2) / CLOCK_MS_DEN);
+#else
+   /* ms = q * CLOCK_MS_DEN + r, only r * CLOCK_MS_NUM needs rounding */
+   uint32_t q = DIV_RECIP(ms, CLOCK_MS_DEN);
+   uint32_t r = ms - q * CLOCK_MS_DEN;
+
+   return (clock_time_t)(q * CLOCK_MS_NUM + DIV_RECIP(r * CLOCK_MS_NUM + CLOCK_MS_DEN/2, CLOCK_MS_DEN));
+#endif
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
@@ -101,11 +101,158 @@
  */
 clock_time_t clock_time(void);
 
+/**
+ * Clock time with 64 bit, measured in the ticks of clock_time_t.
+ *
+ * At 1000 ticks per second the value wraps after 584 million years, so
+ * it is compared with plain operators, see CLOCK64_A_LT_B().
+ */
+typedef uint64_t clock_time64_t;
+
+/**
+ * Check if a 64 bit clock time value is less than another one.
+ *
+ * A 64 bit clock does not wrap, unlike \ref CLOCK_A_LT_B() there is no
+ * limit on the difference of \a a and \a b.  On 32 bit CPUs this is a
+ * compare of the high and the low word.
+ *
+ * \retval true if a < b
+ */
+#define CLOCK64_A_LT_B(a, b) ((clock_time64_t)(a) < (clock_time64_t)(b))
+
+/**
+ * Check if a 64 bit clock time value is greater or equal than another one.
+ *
+ * \retval true if a >= b
+ */
+#define CLOCK64_A_GE_B(a, b) ((clock_time64_t)(a) >= (clock_time64_t)(b))
+
+/**
+ * Get the current clock time with 64 bit.
+ *
+ * The lower 32 bit are equal to clock_time().  Used by timer64, etimer64
+ * and for intervals beyond \ref CLOCK_MAX_DELTA.
+ *
+ * \return The current clock time, measured in system ticks.
+ */
+clock_time64_t clock_time64(void);
+
+/**
+ * Get the seconds since the start of the clock.
+ *
+ * Coarse time base of the \ref stimer "seconds timers".  The counter
+ * wraps after 136 years.  Not affected by clock_adjust() and
+ * clock_slew().
+ *
+ * \return The current time in seconds.
+ */
+uint32_t clock_seconds(void);
+
+/**
+ * Get a free running microsecond counter.
+ *
+ * Used for short time measurements, e.g. the dispatch time budget of
+ * processes.  The counter wraps around after about 71 minutes, so only
+ * differences are meaningful.
+ *
+ * \return The current time in microseconds.
+ */
+uint32_t clock_usecs(void);
+
 /**
  * Initialize the interrupt system for the next etimer event.
  */
 void clock_update( clock_time_t next_event );
 
+/**
+ * Lock the state of the clock against interrupts and the other core,
+ * provided by the port.  Not recursive.
+ *
+ * \return State to pass to clock_arch_unlock().
+ */
+uint32_t clock_arch_lock(void);
+
+/**
+ * Release the lock taken by clock_arch_lock().
+ */
+void clock_arch_unlock(uint32_t state);
+
+#ifndef CLOCK_CONF_ADJUST
+/**
+ * Support correcting the clock with clock_adjust() and clock_slew(),
+ * e.g. against an RTC or a time server.  Ports then pass their counter
+ * through clock_adjusted().
+ */
+#define CLOCK_CONF_ADJUST       0
+#endif
+
+#ifndef CLOCK_CONF_SLEW_SHIFT
+/** clock_slew() corrects the clock by one tick per 2^CLOCK_CONF_SLEW_SHIFT ticks */
+#define CLOCK_CONF_SLEW_SHIFT   10
+#endif
+
+#if CLOCK_CONF_ADJUST
+/**
+ * Sum of the steps of clock_adjust().  The etimers run on clock_time()
+ * minus this value, so a step leaves their remaining time alone.
+ */
+extern clock_time64_t clock_step;
+
+#define CLOCK_STEP64            clock_step
+#define CLOCK_STEP              ((clock_time_t)clock_step)
+
+/**
+ * Step the clock.
+ *
+ * clock_time() and clock_time64() jump by \a delta ticks in O(1).  Armed
+ * etimers and ctimers keep the time until their expiration, i.e. they
+ * neither expire in a mass nor get reordered, and their expiration time
+ * moves by \a delta.  Timers of the \ref timer "timer library" see the
+ * jump.  Call from process context.
+ *
+ * A negative step is limited to the current clock_time64(), the 64 bit
+ * clock never wraps.
+ *
+ * \param delta Ticks to add to the clock, may be negative.
+ */
+void clock_adjust(int32_t delta);
+
+/**
+ * Correct the clock gradually.
+ *
+ * The clock runs faster (\a delta > 0) or slower by one tick per
+ * 2^CLOCK_CONF_SLEW_SHIFT ticks until it has moved by \a delta relative
+ * to the uncorrected clock, it stays monotonic.  The etimers follow the
+ * corrected clock, so periodic timers move to the corrected phase
+ * without a burst or a skipped period.  A further call adds to the
+ * correction still to do.  Call from process context.
+ *
+ * \param delta Ticks to add to the clock, may be negative.
+ */
+void clock_slew(int32_t delta);
+
+/**
+ * The part of the clock_slew() corrections still to do, in ticks.
+ */
+int32_t clock_slew_remaining(void);
+
+/**
+ * The corrected clock for the uncorrected counter \a raw.  Called by the
+ * port in clock_time64() with clock_arch_lock() held, does not change any
+ * state.
+ */
+clock_time64_t clock_adjusted(clock_time64_t raw);
+
+/**
+ * The clock before clock_adjust() and clock_slew(), provided by the port.
+ * Called with clock_arch_lock() held.
+ */
+clock_time64_t clock_time64_raw(void);
+#else
+#define CLOCK_STEP64            0
+#define CLOCK_STEP              0
+#endif
+
 /**
  * A second, measured in system clock time.
  *
@@ -117,20 +264,107 @@ void clock_update( clock_time_t next_event );
 // no default value here!
 #endif
 
-/** Convert milliseconds to clock ticks (integer version).  Range 0..500000ms */
-#define MS_TO_CLOCK_SECOND(MS)     ((clock_time_t)(((MS) * CLOCK_SECOND + 1000/2) / 1000))
+#ifdef CLOCK_SECOND
+/*
+ * The ratios of clock ticks to milli- and microseconds reduced by their
+ * greatest common divisor, i.e. by the powers of 2 and 5 CLOCK_SECOND
+ * has in common with 10^3 resp. 10^6.  Constant expressions, also
+ * usable in #if.
+ */
+#define CLOCK_GCD2_(M)   ((CLOCK_SECOND % 64 == 0  &&  (M) % 64 == 0) ? 64 : (CLOCK_SECOND % 32 == 0  &&  (M) % 32 == 0) ? 32 : \
+                          (CLOCK_SECOND % 16 == 0  &&  (M) % 16 == 0) ? 16 : (CLOCK_SECOND %  8 == 0  &&  (M) %  8 == 0) ?  8 : \
+                          (CLOCK_SECOND %  4 == 0  &&  (M) %  4 == 0) ?  4 : (CLOCK_SECOND %  2 == 0  &&  (M) %  2 == 0) ?  2 : 1)
+#define CLOCK_GCD5_(M)   ((CLOCK_SECOND % 15625 == 0  &&  (M) % 15625 == 0) ? 15625 : (CLOCK_SECOND % 3125 == 0  &&  (M) % 3125 == 0) ? 3125 : \
+                          (CLOCK_SECOND %   625 == 0  &&  (M) %   625 == 0) ?   625 : (CLOCK_SECOND %  125 == 0  &&  (M) %  125 == 0) ?  125 : \
+                          (CLOCK_SECOND %    25 == 0  &&  (M) %    25 == 0) ?    25 : (CLOCK_SECOND %    5 == 0  &&  (M) %    5 == 0) ?    5 : 1)
+
+#define CLOCK_MS_NUM     (CLOCK_SECOND / (CLOCK_GCD2_(1000) * CLOCK_GCD5_(1000)))        /**< ticks per CLOCK_MS_DEN milliseconds */
+#define CLOCK_MS_DEN     (1000 / (CLOCK_GCD2_(1000) * CLOCK_GCD5_(1000)))
+#define CLOCK_US_NUM     (CLOCK_SECOND / (CLOCK_GCD2_(1000000) * CLOCK_GCD5_(1000000)))  /**< ticks per CLOCK_US_DEN microseconds */
+#define CLOCK_US_DEN     (1000000 / (CLOCK_GCD2_(1000000) * CLOCK_GCD5_(1000000)))
+#endif
+
+/**
+ * Convert milliseconds to clock ticks (integer version), rounded.  Without
+ * overflow of intermediates for the full 32 bit range of \a MS, for
+ * CLOCK_SECOND 1000 this is \a MS itself.  A constant \a MS is converted
+ * at compile time, else clock_ms_to_ticks() avoids the 64 bit division.
+ */
+#define MS_TO_CLOCK_SECOND(MS)     ((CLOCK_MS_DEN == 1) ? (clock_time_t)(MS) * CLOCK_MS_NUM \
+                                    : __builtin_constant_p(MS) ? (clock_time_t)(((uint64_t)(MS) * CLOCK_MS_NUM + CLOCK_MS_DEN/2) / CLOCK_MS_DEN) \
+                                    : clock_ms_to_ticks(MS))
 
 /** Convert milliseconds to clock ticks (floating point version) */
 #define MS_TO_CLOCK_SECOND_F(MS)   ((clock_time_t)(((float)(MS) * (float)CLOCK_SECOND) / 1000.0 + 0.5))
 
-/** Convert seconds to clock ticks (integer version).  Range 0..500000s */
-#define SEC_TO_CLOCK_SECOND(SEC)   ((clock_time_t)((SEC) * CLOCK_SECOND))
+/** Convert seconds to clock ticks (integer version).  Range 0..CLOCK_MAX_DELTA ticks */
+#define SEC_TO_CLOCK_SECOND(SEC)   ((clock_time_t)(SEC) * CLOCK_SECOND)
+
+/** Convert minutes to clock ticks (integer version).  Range 0..CLOCK_MAX_DELTA ticks */
+#define MIN_TO_CLOCK_SECOND(MIN)   ((clock_time_t)(MIN) * (60UL * CLOCK_SECOND))
+
+/**
+ * Convert clock ticks to milliseconds, rounded.  Without overflow of
+ * intermediates, the result wraps like the clock ticks.
+ */
+#define CLOCK_SECOND_TO_MS(TICKS)  ((CLOCK_MS_NUM == 1) ? (uint32_t)(TICKS) * CLOCK_MS_DEN \
+                                                        : (uint32_t)(((uint64_t)(TICKS) * CLOCK_MS_DEN + CLOCK_MS_NUM/2) / CLOCK_MS_NUM))
+
+/**
+ * State of the conversion of a free running microsecond counter to
+ * clock ticks, see clock_conv_ticks().  Zero initialized it starts at 0us.
+ */
+struct clock_conv {
+  uint64_t us;                  /**< counter value of the last conversion */
+  clock_time64_t ticks;         /**< ticks at \c us, rounded down */
+  uint32_t frac;                /**< remainder of \c ticks in 1/CLOCK_US_DEN ticks */
+};
+
+/**
+ * Convert a microsecond counter to clock ticks.
+ *
+ * For ports whose hardware counts microseconds.  The result is exactly
+ * \a now_us * CLOCK_SECOND / 10^6 rounded down, without drift, but
+ * instead of a 64 bit multiply and divide only the time since the last
+ * call is converted: with 32 bit arithmetic, a fractional accumulator
+ * and a shift or a reciprocal multiplication chosen at compile time.
+ * Not reentrant, the port must serialize the calls.
+ *
+ * \param c       Conversion state
+ * \param now_us  The counter, must not go backwards
+ * \return        The clock time
+ */
+clock_time64_t clock_conv_ticks(struct clock_conv *c, uint64_t now_us);
+
+/**
+ * State of the conversion of a free running microsecond counter to
+ * seconds, see clock_conv_seconds().  Zero initialized it starts at 0us.
+ */
+struct clock_conv_sec {
+  uint64_t us;                  /**< counter value of the last conversion */
+  uint32_t seconds;             /**< seconds at \c us, rounded down */
+  uint32_t frac;                /**< remainder of \c seconds in microseconds */
+};
 
-/** Convert minutes to clock ticks (integer version).  Range 0..8500min */
-#define MIN_TO_CLOCK_SECOND(MIN)   ((clock_time_t)(60UL * (MIN) * CLOCK_SECOND))
+/**
+ * Convert a microsecond counter to seconds.
+ *
+ * Like clock_conv_ticks(), only the time since the last call is divided,
+ * with 32 bit arithmetic.  Not reentrant, the port must serialize the
+ * calls.
+ *
+ * \param c       Conversion state
+ * \param now_us  The counter, must not go backwards
+ * \return        The seconds, rounded down
+ */
+uint32_t clock_conv_seconds(struct clock_conv_sec *c, uint64_t now_us);
 
-/** Convert clock ticks to milliseconds.  Beware of overflow after 4 million ticks! */
-#define CLOCK_SECOND_TO_MS(TICKS)  ((uint32_t)(((TICKS) * 1000 + CLOCK_SECOND/2) / CLOCK_SECOND))
+/**
+ * Convert milliseconds to clock ticks, rounded, the run time part of
+ * MS_TO_CLOCK_SECOND().  A shift or a reciprocal multiplication instead
+ * of a 64 bit division.
+ */
+clock_time_t clock_ms_to_ticks(uint32_t ms);
 
 #ifdef __cplusplus
     }
@@ -46,9 +46,11 @@
 #include "contiki.h"
 #include "lib/list.h"
 
-LIST(ctimer_list);
-
-static char initialized;
+/*
+ * Shortcuts to the state of the selected scheduler context.
+ */
+#define ctimer_list   ((list_t)&PROCESS_CTX->ctimer_list)
+#define initialized   (PROCESS_CTX->ctimer_initialized)
 
 #define DEBUG 0
 #if DEBUG
@@ -59,7 +61,7 @@ static char initialized;
 #endif
 
 /*---------------------------------------------------------------------------*/
-PROCESS(ctimer_process, "Ctimer process");
+PROCESS_WITH_MAILBOX(ctimer_process, "Ctimer process", PROCESS_CONF_SERVICE_MAILBOX_SIZE);
 PROCESS_THREAD(ctimer_process, ev, data)
 {
   struct ctimer *c;
@@ -87,12 +89,53 @@ PROCESS_THREAD(ctimer_process, ev, data)
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_CONTEXTS
+void
+ctimer_context_init(void)
+{
+  struct process *p = &ctimer_process;
+
+  if(PROCESS_CTX != &process_default_ctx) {
+    p = &PROCESS_CTX->ctimer_proc;
+    p->desc = &process_desc_ctimer_process;
+#if PROCESS_CONF_MAILBOXES
+    p->mbox.slots = PROCESS_CTX->ctimer_mail;
+    p->mbox.mask = PROCESS_CONF_SERVICE_MAILBOX_SIZE - 1;
+#endif
+  }
+  p->next = NULL;
+  PROCESS_CTX->ctimer_process = p;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+/*
+ * Stop the ctimers of the exiting process \a p, their callbacks must not
+ * run in the context of a dead process.
+ */
+static void
+exit_hook(struct process *p)
+{
+  struct ctimer *c = list_head(ctimer_list);
+
+  while(c != NULL) {
+    struct ctimer *next = c->next;
+
+    if(c->p == p) {
+      ctimer_stop(c);
+    }
+    c = next;
+  }
+}
+
+static struct process_exit_hook ctimer_exit_hook = { NULL, exit_hook };
+/*---------------------------------------------------------------------------*/
 void
 ctimer_init(void)
 {
   initialized = 0;
   list_init(ctimer_list);
-  process_start(&ctimer_process, NULL);
+  process_add_exit_hook(&ctimer_exit_hook);
+  process_start(&CTIMER_PROCESS, NULL);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -111,9 +154,9 @@ ctimer_set_with_process(struct ctimer *c, clock_time_t t,
   c->f = f;
   c->ptr = ptr;
   if(initialized) {
-    PROCESS_CONTEXT_BEGIN(&ctimer_process);
+    PROCESS_CONTEXT_BEGIN(&CTIMER_PROCESS);
     etimer_set(&c->etimer, t);
-    PROCESS_CONTEXT_END(&ctimer_process);
+    PROCESS_CONTEXT_END(&CTIMER_PROCESS);
   } else {
     c->etimer.timer.interval = t;
   }
@@ -125,9 +168,9 @@ void
 ctimer_reset(struct ctimer *c)
 {
   if(initialized) {
-    PROCESS_CONTEXT_BEGIN(&ctimer_process);
+    PROCESS_CONTEXT_BEGIN(&CTIMER_PROCESS);
     etimer_reset(&c->etimer);
-    PROCESS_CONTEXT_END(&ctimer_process);
+    PROCESS_CONTEXT_END(&CTIMER_PROCESS);
   }
 
   list_add(ctimer_list, c);
@@ -137,9 +180,9 @@ void
 ctimer_restart(struct ctimer *c)
 {
   if(initialized) {
-    PROCESS_CONTEXT_BEGIN(&ctimer_process);
+    PROCESS_CONTEXT_BEGIN(&CTIMER_PROCESS);
     etimer_restart(&c->etimer);
-    PROCESS_CONTEXT_END(&ctimer_process);
+    PROCESS_CONTEXT_END(&CTIMER_PROCESS);
   }
 
   list_add(ctimer_list, c);
@@ -151,7 +194,6 @@ ctimer_stop(struct ctimer *c)
   if(initialized) {
     etimer_stop(&c->etimer);
   } else {
-    c->etimer.next = NULL;
     c->etimer.p = PROCESS_NONE;
   }
   list_remove(ctimer_list, c);
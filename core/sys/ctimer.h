@@ -166,6 +166,23 @@ int ctimer_expired(struct ctimer *c);
  */
 void ctimer_init(void);
 
+#if PROCESS_CONF_CONTEXTS
+/**
+ * \brief      Set up the ctimer process of the selected context.  Called by process_init().
+ */
+void ctimer_context_init(void);
+#endif
+
+/** The ctimer process of the default context */
+PROCESS_NAME(ctimer_process);
+
+#if PROCESS_CONF_CONTEXTS
+   /* each scheduler context has its own ctimer process, for the core */
+   #define CTIMER_PROCESS (*PROCESS_CTX->ctimer_process)
+#else
+   #define CTIMER_PROCESS ctimer_process
+#endif
+
 #ifdef __cplusplus
     }
 #endif //__cplusplus
@@ -0,0 +1,156 @@
+/**
+ * \addtogroup etimer
+ * @{
+ */
+
+/**
+ * \file
+ * Configuration of the etimer module and state of its queue backends.
+ *
+ * The armed etimers of a scheduler context are kept in one of three
+ * data structures, selected at compile time with ETIMER_CONF_BACKEND:
+ *
+ * - ETIMER_BACKEND_LIST: the classic list sorted by expiration time.
+ *   Expiry is O(1), etimer_set() and etimer_stop() are O(n).  Smallest
+ *   RAM footprint, the best choice for a handful of timers.
+ * - ETIMER_BACKEND_HEAP: a binary min heap in a fixed array of
+ *   ETIMER_CONF_HEAP_SIZE pointers.  Insert, stop and expiry are
+ *   O(log n).  Timers beyond the size of the heap wait in a sorted
+ *   spill list, which is O(n), and move into the heap when it has room.
+ * - ETIMER_BACKEND_WHEEL: a hierarchical timing wheel with
+ *   ETIMER_CONF_WHEEL_LEVELS levels of 32 slots, each level covering 5
+ *   more bits of the clock.  Insert, stop and re-arm are O(1), each
+ *   timer is moved down at most once per level until it expires.
+ *   Timers beyond the range of the wheel wait in an overflow list.
+ *
+ * All backends deliver the timers in the order of their expiration
+ * time.  Only the sorted list guarantees first set, first delivered for
+ * timers with the same expiration time.  The wheel tells an armed
+ * timer by its links, so etimers in reused memory must be passed to
+ * etimer_init() before their first use.
+ */
+
+#ifndef __ETIMER_QUEUE_H__
+#define __ETIMER_QUEUE_H__
+
+#include <stdint.h>
+#include "contiki-conf.h"
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif //__cplusplus
+
+#define ETIMER_BACKEND_LIST     0
+#define ETIMER_BACKEND_HEAP     1
+#define ETIMER_BACKEND_WHEEL    2
+
+#ifndef ETIMER_CONF_BACKEND
+/** Data structure of the armed etimers, one of ETIMER_BACKEND_xxx */
+#define ETIMER_CONF_BACKEND     ETIMER_BACKEND_LIST
+#endif
+
+#ifndef ETIMER_CONF_HEAP_SIZE
+/** Size of the heap of ETIMER_BACKEND_HEAP, further armed etimers of a scheduler context are spilled into a list */
+#define ETIMER_CONF_HEAP_SIZE   64
+#endif
+
+#ifndef ETIMER_CONF_WHEEL_LEVELS
+/** Number of levels of the timing wheel, the wheel covers 2^(5*levels) clock ticks */
+#define ETIMER_CONF_WHEEL_LEVELS 5
+#endif
+
+#ifndef ETIMER_CONF_SLACK
+/**
+ * Support timer slack, see etimer_set_slack().  Adds 16 bit to each
+ * etimer and a bounded search of the queue whenever the wake-up time
+ * is recomputed.
+ */
+#define ETIMER_CONF_SLACK       0
+#endif
+
+/** Largest slack of an etimer in clock ticks */
+#define ETIMER_MAX_SLACK        0xffffU
+
+#ifndef ETIMER_CONF_PERIODIC
+/**
+ * Support periodic etimers, see etimer_set_periodic().  Adds 24 bit to
+ * each etimer.
+ */
+#define ETIMER_CONF_PERIODIC    0
+#endif
+
+#ifndef ETIMER_CONF_DIRECT_DELIVERY
+/**
+ * Deliver PROCESS_EVENT_TIMER from a list of expired etimers kept by the
+ * scheduler instead of posting it to the event queue, so a burst of
+ * expiries does not use up the queue, see process_post_timer().  Adds
+ * two pointers and 16 bit to each etimer.  Cannot be combined with
+ * PROCESS_CONF_FAIRNESS, whose out of order delivery breaks the position
+ * of the expiry in the queue.
+ */
+#define ETIMER_CONF_DIRECT_DELIVERY 0
+#endif
+
+#ifndef ETIMER_CONF_SCHEDULER_EXPIRY
+/**
+ * Let process_run() compare the next expiration time with the clock and
+ * run the expiry pass itself, see etimer_run(), so the main loop need not
+ * poll etimer_process.  Costs a clock_time() call per process_run()
+ * while timers are armed.  With 0 the main loop or the clock interrupt
+ * must poll etimer_process, see etimer_request_poll().
+ */
+#define ETIMER_CONF_SCHEDULER_EXPIRY 1
+#endif
+
+#ifndef ETIMER_CONF_DEFERRED_UPDATE
+/**
+ * Recompute the wake-up time and call clock_update() at most once per
+ * process_run() instead of on every etimer_set(), reset, stop by exit
+ * and expiry pass, see etimer_sync().
+ */
+#define ETIMER_CONF_DEFERRED_UPDATE 1
+#endif
+
+/** Slots per level of the timing wheel */
+#define ETIMER_WHEEL_SLOTS      32
+
+struct etimer;
+
+/**
+ * Armed etimers of a scheduler context, see struct process_context.
+ */
+struct etimer_queue {
+#if ETIMER_CONF_BACKEND == ETIMER_BACKEND_HEAP
+  struct etimer *heap[ETIMER_CONF_HEAP_SIZE];
+  uint16_t n;
+  struct etimer *spill;             /**< sorted timers which do not fit into the heap */
+#elif ETIMER_CONF_BACKEND == ETIMER_BACKEND_WHEEL
+  /* level * ETIMER_WHEEL_SLOTS + slot, followed by the overflow and the due list */
+  struct etimer *bucket[ETIMER_CONF_WHEEL_LEVELS * ETIMER_WHEEL_SLOTS + 2];
+  uint32_t occupied[ETIMER_CONF_WHEEL_LEVELS];  /**< non-empty slots per level */
+  clock_time_t now;                             /**< timers before this tick have been processed */
+#else
+  struct etimer *list;
+#endif
+#if ETIMER_CONF_SCHEDULER_EXPIRY
+  uint8_t armed;                    /**< next_expiration of the context is valid */
+#endif
+#if ETIMER_CONF_DEFERRED_UPDATE
+  uint8_t stale;                    /**< the wake-up time must be recomputed */
+#endif
+#if PROCESS_CONF_STATS
+  uint32_t wakeups;                 /**< expiry passes which delivered timers */
+  uint32_t coalesced;               /**< deadlines delivered by the pass of an earlier deadline */
+  uint32_t alarms;                  /**< wake-up time computations, i.e. calls of clock_update() */
+  uint32_t alarms_saved;            /**< changes of the queue merged into a later computation */
+#endif
+};
+
+#ifdef __cplusplus
+    }
+#endif //__cplusplus
+
+#endif /* __ETIMER_QUEUE_H__ */
+
+/** @} */
@@ -44,6 +44,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include "contiki-conf.h"
 #include "sys/etimer.h"
 #include "sys/process.h"
@@ -52,151 +53,992 @@
    #define CONTIKI_ETIMER_DEBUGPRINTF(...)
 #endif
 
-static struct etimer *timerlist;
-static clock_time_t next_expiration;
+/*
+ * Shortcuts to the state of the selected scheduler context.
+ */
+#define etimers          (PROCESS_CTX->etimers)
+#define next_expiration  (PROCESS_CTX->next_expiration)
+
+/*
+ * The timers run on the clock without the steps of clock_adjust(), so a
+ * step leaves the queue alone.  etimer_now() is the snapshot of the round.
+ */
+#define etimer_clock()   (clock_time() - CLOCK_STEP)
+#define etimer_now()     (process_now() - CLOCK_STEP)
+
+/*
+ * Due timers which one expiry pass may hold back: periodic timers behind
+ * the clock and timers whose owner has a full mailbox.
+ */
+#define ETIMER_BURST_BATCH  4
+
+#define ETIMER_HOLD  (ETIMER_CONF_PERIODIC  ||  (PROCESS_CONF_MAILBOXES  &&  !ETIMER_CONF_DIRECT_DELIVERY))
+
+PROCESS_WITH_MAILBOX(etimer_process, "Event timer", PROCESS_CONF_SERVICE_MAILBOX_SIZE);
+/*---------------------------------------------------------------------------*/
+static clock_time_t expiration(const struct etimer *et)
+{
+   return et->timer.start + et->timer.interval;
+}
+/*---------------------------------------------------------------------------*/
+#if ETIMER_CONF_SLACK
+/* latest delivery time of \a et, lowers the wake-up time \a w */
+static void lower_wakeup(const struct etimer *et, clock_time_t *w)
+{
+   clock_time_t latest = expiration(et) + et->slack;
+
+   if (CLOCK_A_LT_B(latest, *w)) {
+      *w = latest;
+   }
+}
+#endif
+/*---------------------------------------------------------------------------*/
+/*
+ * Queue backends.  Each one provides
+ * - queue_init(): empty queue
+ * - queue_contains(): is the timer in the queue, the timer is zero initialized or was armed before
+ * - queue_insert() / queue_remove()
+ * - queue_first(): expiration time of the first timer, zero if the queue is empty
+ * - queue_next_due(): the timer to check for expiry next, NULL if there is none
+ * - queue_wakeup(): lower the wake-up time by the slack of all timers expiring before it
+ * - etimer_next_armed()
+ */
+#if ETIMER_CONF_BACKEND == ETIMER_BACKEND_HEAP
+
+/*
+ * Timers beyond ETIMER_CONF_HEAP_SIZE wait in the spill list, sorted by
+ * expiration time.  They are O(n) like the list backend and move into the
+ * heap as soon as it has room.
+ */
+
+static void queue_init(void)
+{
+   etimers.n = 0;
+   etimers.spill = NULL;
+}
+
+static int16_t heap_holds(struct etimer *et)
+{
+   return et->index < etimers.n  &&  etimers.heap[et->index] == et;
+}
+
+static int16_t queue_contains(struct etimer *et)
+{
+   struct etimer *t;
+
+   if (heap_holds(et)) {
+      return 1;
+   }
+   /* the spill list is searched, so an uninitialized timer is harmless */
+   for (t = etimers.spill; t != NULL; t = t->next) {
+      if (t == et) {
+         return 1;
+      }
+   }
+   return 0;
+}
+
+static void heap_place(struct etimer *et, uint16_t i)
+{
+   etimers.heap[i] = et;
+   et->index = i;
+}
+
+static void heap_up(struct etimer *et)
+{
+   clock_time_t exp = expiration(et);
+   uint16_t i = et->index;
+
+   while (i > 0) {
+      struct etimer *parent = etimers.heap[(i - 1) / 2];
+
+      if ( !CLOCK_A_LT_B(exp, expiration(parent))) {
+         break;
+      }
+      heap_place(parent, i);
+      i = (i - 1) / 2;
+   }
+   heap_place(et, i);
+}
+
+static void heap_down(struct etimer *et)
+{
+   clock_time_t exp = expiration(et);
+   uint16_t i = et->index;
+
+   for (;;) {
+      uint16_t c = 2*i + 1;
+
+      if (c >= etimers.n) {
+         break;
+      }
+      if (c + 1 < etimers.n  &&  CLOCK_A_LT_B(expiration(etimers.heap[c + 1]), expiration(etimers.heap[c]))) {
+         ++c;
+      }
+      if ( !CLOCK_A_LT_B(expiration(etimers.heap[c]), exp)) {
+         break;
+      }
+      heap_place(etimers.heap[c], i);
+      i = c;
+   }
+   heap_place(et, i);
+}
+
+static void queue_insert(struct etimer *et)
+{
+   if (etimers.n == ETIMER_CONF_HEAP_SIZE) {
+      struct etimer **t;
+      clock_time_t this_exp = expiration(et);
+
+      for (t = &etimers.spill; *t != NULL; t = &((*t)->next)) {
+         if (CLOCK_A_LT_B(this_exp, expiration(*t))) {
+            break;
+         }
+      }
+      et->next  = *t;
+      et->index = ETIMER_CONF_HEAP_SIZE;
+      *t = et;
+      return;
+   }
+
+   et->index = etimers.n++;
+   heap_up(et);
+}
+
+static void queue_remove(struct etimer *et)
+{
+   struct etimer *last;
+
+   if ( !heap_holds(et)) {
+      struct etimer **t;
+
+      for (t = &etimers.spill; *t != et; t = &((*t)->next)) {
+      }
+      *t = et->next;
+      et->next = NULL;
+      return;
+   }
+
+   last = etimers.heap[--etimers.n];
+   if (last != et) {
+      heap_place(last, et->index);
+      heap_up(last);
+      heap_down(last);
+   }
+   et->index = ETIMER_CONF_HEAP_SIZE;
+
+   /* the first spilled timer takes the free place */
+   if (etimers.spill != NULL) {
+      struct etimer *t = etimers.spill;
+
+      etimers.spill = t->next;
+      t->next = NULL;
+      queue_insert(t);
+   }
+}
+
+static struct etimer *queue_next_due(void)
+{
+   if (etimers.n == 0) {
+      return etimers.spill;
+   }
+   if (etimers.spill != NULL  &&  CLOCK_A_LT_B(expiration(etimers.spill), expiration(etimers.heap[0]))) {
+      return etimers.spill;
+   }
+   return etimers.heap[0];
+}
+
+static int16_t queue_first(clock_time_t *exp)
+{
+   struct etimer *t = queue_next_due();
+
+   if (t == NULL) {
+      return 0;
+   }
+   *exp = expiration(t);
+   return 1;
+}
+
+#if ETIMER_CONF_SLACK
+static void heap_wakeup(clock_time_t *w, uint16_t i)
+{
+   /* the subtree of a timer expiring at or after the wake-up time can be skipped */
+   if (i < etimers.n  &&  CLOCK_A_LT_B(expiration(etimers.heap[i]), *w)) {
+      lower_wakeup(etimers.heap[i], w);
+      heap_wakeup(w, 2*i + 1);
+      heap_wakeup(w, 2*i + 2);
+   }
+}
+
+static void queue_wakeup(clock_time_t *w)
+{
+   struct etimer *t;
+
+   heap_wakeup(w, 0);
+   for (t = etimers.spill; t != NULL  &&  CLOCK_A_LT_B(expiration(t), *w); t = t->next) {
+      lower_wakeup(t, w);
+   }
+}
+#endif
+
+struct etimer *etimer_next_armed(struct etimer *et)
+{
+   uint16_t i = 0;
+
+   if (et != NULL) {
+      if ( !heap_holds(et)) {
+         return et->next;
+      }
+      i = et->index + 1;
+   }
+   return (i < etimers.n) ? etimers.heap[i] : etimers.spill;
+}
+
+#elif ETIMER_CONF_BACKEND == ETIMER_BACKEND_WHEEL
+
+#if ETIMER_CONF_WHEEL_LEVELS < 1  ||  ETIMER_CONF_WHEEL_LEVELS > 6
+   #error "ETIMER_CONF_WHEEL_LEVELS must be 1..6"
+#endif
+
+#define WHEEL_BITS      5
+#define WHEEL_OVERFLOW  (ETIMER_CONF_WHEEL_LEVELS * ETIMER_WHEEL_SLOTS)
+#define WHEEL_DUE       (WHEEL_OVERFLOW + 1)
+#define WHEEL_BUCKETS   (WHEEL_OVERFLOW + 2)
+#define WHEEL_RANGE     (((clock_time_t)1 << (WHEEL_BITS * ETIMER_CONF_WHEEL_LEVELS)) - 1)
+
+/* slots of a level above slot s */
+#define WHEEL_ABOVE(s)  (((s) == ETIMER_WHEEL_SLOTS - 1) ? 0 : (~(uint32_t)0 << ((s) + 1)))
+
+static void queue_init(void)
+{
+   memset(&etimers, 0, sizeof(etimers));
+   etimers.now = etimer_clock();
+}
+
+static int16_t queue_contains(struct etimer *et)
+{
+   /* O(1), bucket 0 marks a timer which is not armed, see etimer_init() */
+   return et->bucket != 0  &&  et->bucket <= WHEEL_BUCKETS  &&  *et->pprev == et;
+}
+
+static void wheel_link(struct etimer *et, struct etimer **t, uint16_t b)
+{
+   et->bucket = b + 1;
+   et->next   = *t;
+   et->pprev  = t;
+   if (*t != NULL) {
+      (*t)->pprev = &et->next;
+   }
+   *t = et;
+   if (b < WHEEL_OVERFLOW) {
+      etimers.occupied[b / ETIMER_WHEEL_SLOTS] |= (uint32_t)1 << (b % ETIMER_WHEEL_SLOTS);
+   }
+}
+
+static void queue_insert(struct etimer *et)
+{
+   clock_time_t exp = expiration(et);
+   clock_time_t diff = exp ^ etimers.now;
+   uint16_t level;
+
+   if (CLOCK_A_LT_B(exp, etimers.now)) {
+      /* behind the wheel: the due list is kept sorted, it is short */
+      struct etimer **t;
+
+      for (t = &etimers.bucket[WHEEL_DUE]; *t != NULL; t = &((*t)->next)) {
+         if (CLOCK_A_LT_B(exp, expiration(*t))) {
+            break;
+         }
+      }
+      wheel_link(et, t, WHEEL_DUE);
+      return;
+   }
+
+   /* the level is given by the highest bit in which expiration and wheel time differ */
+   level = (diff == 0) ? 0 : (31 - __builtin_clz((unsigned int)diff)) / WHEEL_BITS;
+   if (level >= ETIMER_CONF_WHEEL_LEVELS) {
+      wheel_link(et, &etimers.bucket[WHEEL_OVERFLOW], WHEEL_OVERFLOW);
+   }
+   else {
+      uint16_t b = level * ETIMER_WHEEL_SLOTS + ((exp >> (WHEEL_BITS * level)) & (ETIMER_WHEEL_SLOTS - 1));
+
+      wheel_link(et, &etimers.bucket[b], b);
+   }
+}
+
+static void queue_remove(struct etimer *et)
+{
+   uint16_t b = et->bucket - 1;
+
+   *et->pprev = et->next;
+   if (et->next != NULL) {
+      et->next->pprev = et->pprev;
+   }
+   if (b < WHEEL_OVERFLOW  &&  etimers.bucket[b] == NULL) {
+      etimers.occupied[b / ETIMER_WHEEL_SLOTS] &= ~((uint32_t)1 << (b % ETIMER_WHEEL_SLOTS));
+   }
+   et->next   = NULL;
+   et->bucket = 0;
+}
+
+/*
+ * Find the next non-empty slot after the current wheel time.  Returns
+ * the level (ETIMER_CONF_WHEEL_LEVELS for the overflow list, -1 if the
+ * wheel is empty), in \a t the time at which the slot is reached and in
+ * \a b its bucket.
+ */
+static int16_t wheel_next_slot(clock_time_t *t, uint16_t *b)
+{
+   clock_time_t now = etimers.now;
+   uint16_t level;
+
+   for (level = 0; level < ETIMER_CONF_WHEEL_LEVELS; ++level) {
+      uint16_t shift = WHEEL_BITS * level;
+      uint16_t cur = (now >> shift) & (ETIMER_WHEEL_SLOTS - 1);
+      uint32_t above = etimers.occupied[level] & WHEEL_ABOVE(cur);
+
+      if (above != 0) {
+         uint16_t s = __builtin_ctz((unsigned int)above);
+
+         *t = (now & ~(((clock_time_t)ETIMER_WHEEL_SLOTS << shift) - 1)) | ((clock_time_t)s << shift);
+         *b = level * ETIMER_WHEEL_SLOTS + s;
+         return level;
+      }
+   }
+   if (etimers.bucket[WHEEL_OVERFLOW] != NULL) {
+      *t = (now | WHEEL_RANGE) + 1;
+      *b = WHEEL_OVERFLOW;
+      return ETIMER_CONF_WHEEL_LEVELS;
+   }
+   return -1;
+}
+
+static int16_t queue_first(clock_time_t *exp)
+{
+   struct etimer *t;
+   uint16_t b;
+
+   if (etimers.bucket[WHEEL_DUE] != NULL) {
+      b = WHEEL_DUE;
+   }
+   else if (etimers.bucket[etimers.now & (ETIMER_WHEEL_SLOTS - 1)] != NULL) {
+      b = etimers.now & (ETIMER_WHEEL_SLOTS - 1);
+   }
+   else {
+      clock_time_t start;
+
+      if (wheel_next_slot(&start, &b) < 0) {
+         return 0;
+      }
+   }
+
+   /* the timers of a slot above level 0 are not sorted */
+   *exp = expiration(etimers.bucket[b]);
+   for (t = etimers.bucket[b]->next; t != NULL; t = t->next) {
+      if (CLOCK_A_LT_B(expiration(t), *exp)) {
+         *exp = expiration(t);
+      }
+   }
+   return 1;
+}
+
+static struct etimer *queue_next_due(void)
+{
+   clock_time_t now = etimer_now();
+
+   for (;;) {
+      struct etimer *t;
+      clock_time_t next;
+      uint16_t b;
+      int16_t level;
+
+      if (etimers.bucket[WHEEL_DUE] != NULL) {
+         return etimers.bucket[WHEEL_DUE];
+      }
+      t = etimers.bucket[etimers.now & (ETIMER_WHEEL_SLOTS - 1)];
+      if (t != NULL) {
+         /* expires exactly at the wheel time, which never passes the clock */
+         return t;
+      }
+
+      level = wheel_next_slot(&next, &b);
+      if (level < 0) {
+         etimers.now = now;
+         return NULL;
+      }
+      if (CLOCK_A_LT_B(now, next)) {
+         return NULL;
+      }
+
+      /* advance and move the timers of a higher level slot down */
+      etimers.now = next;
+      if (level > 0) {
+         t = etimers.bucket[b];
+         etimers.bucket[b] = NULL;
+         if (b < WHEEL_OVERFLOW) {
+            etimers.occupied[level] &= ~((uint32_t)1 << (b % ETIMER_WHEEL_SLOTS));
+         }
+         while (t != NULL) {
+            struct etimer *n = t->next;
+
+            queue_insert(t);
+            t = n;
+         }
+      }
+   }
+}
+
+#if ETIMER_CONF_SLACK
+/* visit the timers of bucket \a b if the bucket starts before the wake-up time */
+static int16_t wheel_bucket_wakeup(clock_time_t *w, uint16_t b, clock_time_t start)
+{
+   struct etimer *t;
+
+   if ( !CLOCK_A_LT_B(start, *w)) {
+      return 0;
+   }
+   for (t = etimers.bucket[b]; t != NULL; t = t->next) {
+      if (CLOCK_A_LT_B(expiration(t), *w)) {
+         lower_wakeup(t, w);
+      }
+   }
+   return 1;
+}
+
+static void queue_wakeup(clock_time_t *w)
+{
+   clock_time_t now = etimers.now;
+   struct etimer *t;
+   uint16_t level;
+
+   for (t = etimers.bucket[WHEEL_DUE]; t != NULL; t = t->next) {
+      lower_wakeup(t, w);
+   }
+
+   /* the buckets in the order of time */
+   for (level = 0; level < ETIMER_CONF_WHEEL_LEVELS; ++level) {
+      uint16_t shift = WHEEL_BITS * level;
+      uint16_t cur = (now >> shift) & (ETIMER_WHEEL_SLOTS - 1);
+      uint32_t slots = etimers.occupied[level] & ((level == 0) ? (~(uint32_t)0 << cur) : WHEEL_ABOVE(cur));
+
+      while (slots != 0) {
+         uint16_t s = __builtin_ctz((unsigned int)slots);
+         clock_time_t start = (now & ~(((clock_time_t)ETIMER_WHEEL_SLOTS << shift) - 1)) | ((clock_time_t)s << shift);
+
+         if ( !wheel_bucket_wakeup(w, level * ETIMER_WHEEL_SLOTS + s, start)) {
+            return;
+         }
+         slots &= slots - 1;
+      }
+   }
+   wheel_bucket_wakeup(w, WHEEL_OVERFLOW, (now | WHEEL_RANGE) + 1);
+}
+#endif
+
+struct etimer *etimer_next_armed(struct etimer *et)
+{
+   uint16_t b = 0;
+
+   if (et != NULL) {
+      if (et->next != NULL) {
+         return et->next;
+      }
+      b = et->bucket;
+   }
+   for (; b < WHEEL_BUCKETS; ++b) {
+      if (etimers.bucket[b] != NULL) {
+         return etimers.bucket[b];
+      }
+   }
+   return NULL;
+}
+
+#else
+
+static void queue_init(void)
+{
+   etimers.list = NULL;
+}
+
+static int16_t queue_contains(struct etimer *et)
+{
+   struct etimer *t;
+
+   /* the list is searched, so an uninitialized timer is harmless */
+   for (t = etimers.list; t != NULL; t = t->next) {
+      if (t == et) {
+         return 1;
+      }
+   }
+   return 0;
+}
+
+static void queue_insert(struct etimer *et)
+{
+   struct etimer **t;
+   clock_time_t this_exp = expiration(et);
+
+   // search the (ordered) list and insert new timer
+   for (t = &etimers.list; *t != NULL; t = &((*t)->next)) {
+      if (CLOCK_A_LT_B(this_exp, expiration(*t))) {
+         break;
+      }
+   }
+   et->next  = *t;
+   et->pprev = t;
+   if (*t != NULL) {
+      (*t)->pprev = &et->next;
+   }
+   *t = et;
+}
+
+static void queue_remove(struct etimer *et)
+{
+   *et->pprev = et->next;
+   if (et->next != NULL) {
+      et->next->pprev = et->pprev;
+   }
+   et->next = NULL;
+}
+
+static int16_t queue_first(clock_time_t *exp)
+{
+   if (etimers.list == NULL) {
+      return 0;
+   }
+   *exp = expiration(etimers.list);
+
+#define xCHECK_LIST
+#ifdef CHECK_LIST
+   {
+      struct etimer *t;
+      clock_time_t this_exp = *exp;
+
+      for (t = etimers.list->next; t != NULL; t = t->next) {
+         BTSI_ASSERT( CLOCK_A_GE_B(expiration(t), this_exp) );
+         this_exp = expiration(t);
+      }
+   }
+#endif
+   return 1;
+}
+
+static struct etimer *queue_next_due(void)
+{
+   return etimers.list;
+}
+
+#if ETIMER_CONF_SLACK
+static void queue_wakeup(clock_time_t *w)
+{
+   struct etimer *t;
+
+   for (t = etimers.list; t != NULL  &&  CLOCK_A_LT_B(expiration(t), *w); t = t->next) {
+      lower_wakeup(t, w);
+   }
+}
+#endif
+
+struct etimer *etimer_next_armed(struct etimer *et)
+{
+   return (et == NULL) ? etimers.list : et->next;
+}
 
-PROCESS(etimer_process, "Event timer");
+#endif
 /*---------------------------------------------------------------------------*/
 static void update_time(void)
 /**
  * find the next etimer expiring and initialize the dynamic tick generation accordingly.
  */
 {
+   clock_time_t exp;
+
    assert( !CONTIKI_IN_ISR() );
 
-   if (timerlist == NULL) {
+   if ( !queue_first(&exp)) {
       next_expiration = 0;
+#if ETIMER_CONF_SCHEDULER_EXPIRY
+      etimers.armed = 0;
+#endif
 
       clock_update( clock_time() + MS_TO_CLOCK_SECOND(60000) );    // dummy call to setup a periodic timer interrupt for watchdog triggering
    }
    else {
-      next_expiration = timerlist->timer.start + timerlist->timer.interval;
+#if ETIMER_CONF_SLACK
+      /* wake up as late as the slack of the timers due until then allows */
+      clock_time_t w = exp + ETIMER_MAX_SLACK + 1;
 
-#define xCHECK_LIST
-#ifdef CHECK_LIST
-      struct etimer *t;
-      clock_time_t this_exp;
-      clock_time_t next_exp;
+      queue_wakeup(&w);
+      exp = w;
+#endif
+      next_expiration = exp;
+#if ETIMER_CONF_SCHEDULER_EXPIRY
+      etimers.armed = 1;
+#endif
+      clock_update( next_expiration + CLOCK_STEP );
+   }
+#if PROCESS_CONF_STATS
+   ++etimers.alarms;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+#if ETIMER_CONF_DEFERRED_UPDATE
+/* the queue has changed, the wake-up time is recomputed by etimer_sync() */
+static void request_update(void)
+{
+#if PROCESS_CONF_STATS
+   etimers.alarms_saved += etimers.stale;
+#endif
+   etimers.stale = 1;
+}
+/*---------------------------------------------------------------------------*/
+void etimer_sync(void)
+{
+   if (etimers.stale) {
+      etimers.stale = 0;
+      update_time();
+   }
+}
+#else
+   #define request_update()  update_time()
+#endif
+/*---------------------------------------------------------------------------*/
+static void unlink_timer(struct etimer *et)
+/**
+ * Remove the armed timer \a et from the timer queue and from the list of
+ * its owner and mark it as expired.
+ */
+{
+    queue_remove( et );
 
-      t = timerlist;
-      this_exp = t->timer.start + t->timer.interval;
-      for (t = t->next; t != NULL; t = t->next) {
-         next_exp = t->timer.start + t->timer.interval;
+    if (et->p != PROCESS_NONE) {
+        *et->owned_pprev = et->owned_next;
+        if (et->owned_next != NULL) {
+            et->owned_next->owned_pprev = et->owned_pprev;
+        }
+        --et->p->ntimers;
+    }
 
-         BTSI_ASSERT( CLOCK_A_GE_B(next_exp, this_exp) );
-         this_exp = next_exp;
-      }
-#endif
+    et->p = PROCESS_NONE;
+}
+/*---------------------------------------------------------------------------*/
+static void exit_hook(struct process *p)
+/**
+ * Remove the timers of the exiting process \a p, O(number of its timers).
+ * As in the original Contiki they are not marked as expired, so a process
+ * waiting for etimer_expired() does not continue on PROCESS_EVENT_EXIT.
+ */
+{
+    if (p->timers != NULL) {
+        while (p->timers != NULL) {
+            struct etimer *et = p->timers;
 
-      clock_update( next_expiration );
-   }
+            queue_remove( et );
+            p->timers = et->owned_next;
+        }
+        p->ntimers = 0;
+        request_update();
+    }
 }
+
+static struct process_exit_hook etimer_exit_hook = { NULL, exit_hook };
 /*---------------------------------------------------------------------------*/
-PROCESS_THREAD(etimer_process, ev, data)
+#if ETIMER_CONF_PERIODIC
+static int16_t rearm(struct etimer *t, clock_time_t exp)
+/**
+ * Move the delivered periodic timer \a t with deadline \a exp to its
+ * next period boundary.  Returns zero if a burst timer is still behind
+ * the clock, it is then left out of the queue.
+ */
 {
-    PROCESS_BEGIN();
+    clock_time_t period = t->timer.interval;
+    clock_time_t missed = (etimer_now() - exp) / period;
 
-    timerlist = NULL;
+    queue_remove( t );
+    if (t->periodic == ETIMER_PERIODIC_BURST) {
+        t->timer.start = exp;
+        if (missed != 0) {
+            return 0;
+        }
+    }
+    else {
+        t->timer.start = exp + missed * period;
+        if (t->periodic == ETIMER_PERIODIC_REPORT) {
+            t->overruns = (missed > 0xffffU - t->overruns) ? 0xffffU : t->overruns + missed;
+        }
+    }
+    queue_insert( t );
+    return 1;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+void etimer_run(void)
+{
+    struct etimer *t;
+#if ETIMER_HOLD
+    struct etimer *held[ETIMER_BURST_BATCH];
+    uint16_t nheld = 0;
+#endif
+#if PROCESS_CONF_STATS
+    clock_time_t last = 0;
+    uint16_t n = 0;
+#endif
 
-    for (;;) {
-        PROCESS_YIELD();
+    while ((t = queue_next_due()) != NULL) {
+        // the deadline before timer_expired_at() catches up the start of an overdue timer
+        clock_time_t exp = expiration(t);
 
-        if (ev == PROCESS_EVENT_EXITED) {
-            struct etimer **t;
-            struct process *p = data;
+        if ( !timer_expired_at( &(t->timer), etimer_now())) {
+            break;
+        }
+#if PROCESS_CONF_STATS
+        /* each further deadline in this pass would have been a wake-up of its own */
+        if (n++ == 0) {
+            ++etimers.wakeups;
+        }
+        else if (exp != last) {
+            ++etimers.coalesced;
+        }
+        last = exp;
+#endif
+#if !defined(NDEBUG)
+        {
+            // 20ms too late are allowed
+            int32_t delay = (int32_t)(etimer_now() - exp);
+            if (delay > (int32_t)MS_TO_CLOCK_SECOND(20)) {
+                CONTIKI_ETIMER_DEBUGPRINTF( "--> etimer: delayed by %ld ticks in '%s':%d\n",
+                                            delay, PROCESS_NAME_STRING(t->p), t->p->pt.lc );
+            }
+        }
+#endif
 
-            t = &timerlist;
-            while (*t != NULL) {
-                if ((*t)->p == p) {
-                    *t = (*t)->next;
-                }
-                else {
-                    t = &((*t)->next);
-                }
+#if ETIMER_CONF_DIRECT_DELIVERY && ETIMER_CONF_PERIODIC
+        if (t->periodic == ETIMER_PERIODIC_BURST  &&  process_timer_pending( t )) {
+            // the previous period is not delivered yet, this one stays due
+            t->timer.start = exp - t->timer.interval;
+            queue_remove( t );
+            held[nheld++] = t;
+            if (nheld == ETIMER_BURST_BATCH) {
+                break;
             }
-            update_time();
+            continue;
         }
-        else if (ev == PROCESS_EVENT_POLL) {
-            while (timerlist != NULL  &&  timer_expired( &(timerlist->timer))) {
-                struct etimer *t = timerlist;
+#endif
 
-#if !defined(NDEBUG)
-                {
-                    // 20ms too late are allowed
-                    int32_t delay = (int32_t)(clock_time() - (t->timer.start + t->timer.interval));
-                    if (delay > (int32_t)MS_TO_CLOCK_SECOND(20)) {
-                        CONTIKI_ETIMER_DEBUGPRINTF( "--> etimer: delayed by %ld ticks in '%s':%d\n",
-                                                    delay, t->p->name, t->p->pt.lc );
-                    }
-                }
+#if PROCESS_CONF_MAILBOXES && !ETIMER_CONF_DIRECT_DELIVERY
+        if (process_mailbox_space( t->p ) == 0) {
+            // the mailbox of the owner is full, the timer stays due until the owner has taken an event
+            t->timer.start = exp - t->timer.interval;
+            queue_remove( t );
+            held[nheld++] = t;
+            if (nheld == ETIMER_BURST_BATCH) {
+                break;
+            }
+            continue;
+        }
 #endif
 
-                process_post( t->p, PROCESS_EVENT_TIMER, t );
+#if ETIMER_CONF_DIRECT_DELIVERY
+        if ( !process_post_timer( t->p, t )) {
+            // the previous expiry is not delivered yet, both are delivered as one event
+#if ETIMER_CONF_PERIODIC
+            if (t->periodic == ETIMER_PERIODIC_REPORT  &&  t->overruns != 0xffffU) {
+                ++t->overruns;
+            }
+#endif
+        }
+#else
+        process_post( t->p, PROCESS_EVENT_TIMER, t );
+#endif
 
-                // remove timer from list and reset the process id for etimer_expired()
-                timerlist = t->next;
-                t->p    = PROCESS_NONE;
-                t->next = NULL;
+#if ETIMER_CONF_PERIODIC
+        if (t->periodic != 0) {
+            if ( !rearm( t, exp )) {
+                held[nheld++] = t;
+                if (nheld == ETIMER_BURST_BATCH) {
+                    break;
+                }
             }
-            update_time();
+            continue;
+        }
+#endif
+
+        // remove timer from queue and reset the process id for etimer_expired()
+        unlink_timer( t );
+    }
+#if ETIMER_HOLD
+    // timers which are still behind or undeliverable get their turn in the next pass
+    if (nheld != 0) {
+        while (nheld != 0) {
+            queue_insert( held[--nheld] );
+        }
+        etimer_request_poll();
+    }
+#endif
+    request_update();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_process, ev, data)
+{
+    (void)data;
+
+    PROCESS_BEGIN();
+
+    queue_init();
+#if ETIMER_CONF_SCHEDULER_EXPIRY
+    etimers.armed = 0;
+#endif
+#if ETIMER_CONF_DEFERRED_UPDATE
+    etimers.stale = 0;
+#endif
+#if PROCESS_CONF_STATS
+    etimer_stats_reset();
+#endif
+    process_add_exit_hook( &etimer_exit_hook );
+
+    for (;;) {
+        PROCESS_YIELD();
+
+        if (ev == PROCESS_EVENT_POLL) {
+            etimer_run();
         }
     }
 
     PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_CONTEXTS
+void etimer_context_init(void)
+{
+   struct process *p = &etimer_process;
+
+   if (PROCESS_CTX != &process_default_ctx) {
+      p = &PROCESS_CTX->etimer_proc;
+      p->desc = &process_desc_etimer_process;
+#if PROCESS_CONF_MAILBOXES
+      p->mbox.slots = PROCESS_CTX->etimer_mail;
+      p->mbox.mask  = PROCESS_CONF_SERVICE_MAILBOX_SIZE - 1;
+#endif
+   }
+   p->next = NULL;
+   PROCESS_CTX->etimer_process = p;
+}
+/*---------------------------------------------------------------------------*/
+struct process *etimer_context_process(void)
+{
+   return &ETIMER_PROCESS;
+}
+#endif
+/*---------------------------------------------------------------------------*/
 void etimer_request_poll(void)
 {
-   process_poll(&etimer_process);
+   process_poll(&ETIMER_PROCESS);
 }
 /*---------------------------------------------------------------------------*/
 static void add_timer(struct etimer *timer)
 {
-   struct etimer **t;
-   clock_time_t this_exp;
-
+#if !ETIMER_CONF_SCHEDULER_EXPIRY
    etimer_request_poll();
+#endif
 
-   if (timer->p != PROCESS_NONE) {
-      /* Timer on list? */
-
-      for (t = &timerlist; *t != NULL; t = &((*t)->next)) {
-         if (*t == timer) {
-            /* Timer already on list, temporarily remove it from list. */
+   if (queue_contains(timer)) {
+      /* Timer already armed, temporarily remove it from the queue. */
 #if !defined(NDEBUG)
-            if (timer->p != PROCESS_CURRENT()) {
-                CONTIKI_ETIMER_DEBUGPRINTF( "--> etimer: etimer gets new owner %s->%s\n", timer->p->name, PROCESS_CURRENT()->name );
-            }
-#endif
-            *t = timer->next;
-            break;
-         }
+      if (timer->p != PROCESS_CURRENT()) {
+          CONTIKI_ETIMER_DEBUGPRINTF( "--> etimer: etimer gets new owner %s->%s\n", PROCESS_NAME_STRING(timer->p), PROCESS_NAME_STRING(PROCESS_CURRENT()) );
       }
+#endif
+      unlink_timer(timer);
    }
 
-   // search the (ordered) list and insert new timer
-   this_exp = timer->timer.start + timer->timer.interval;
-   for (t = &timerlist; *t != NULL; t = &((*t)->next)) {
-       clock_time_t next_exp;
+   queue_insert(timer);
 
-       next_exp = (*t)->timer.start + (*t)->timer.interval;
-       if (CLOCK_A_LT_B(this_exp, next_exp)) {
-           break;
-       }
+   // link into the list of the owner
+   timer->p = PROCESS_CURRENT();
+   if (timer->p != PROCESS_NONE) {
+      struct process *p = timer->p;
+
+      timer->owned_next  = p->timers;
+      timer->owned_pprev = &p->timers;
+      if (p->timers != NULL) {
+         p->timers->owned_pprev = &timer->owned_next;
+      }
+      p->timers = timer;
+      ++p->ntimers;
    }
-   timer->next = *t;
-   timer->p    = PROCESS_CURRENT();
-   *t = timer;
 
-   update_time();
+   request_update();
+#if ETIMER_CONF_SCHEDULER_EXPIRY
+   /* keep process_run() going for a timer which is due already */
+   if ( !CLOCK_A_LT_B(etimer_clock(), expiration(timer))) {
+      etimer_request_poll();
+   }
+#endif
+}
+/*---------------------------------------------------------------------------*/
+void etimer_init(struct etimer *et)
+{
+   memset(et, 0, sizeof(*et));
 }
 /*---------------------------------------------------------------------------*/
 void etimer_set(struct etimer *et, clock_time_t interval)
 {
    timer_set(&et->timer, interval);
+   et->timer.start -= CLOCK_STEP;
+#if ETIMER_CONF_SLACK
+   et->slack = 0;
+#endif
+#if ETIMER_CONF_PERIODIC
+   et->periodic = 0;
+#endif
    add_timer(et);
 }
 /*---------------------------------------------------------------------------*/
+void etimer_set_slack(struct etimer *et, clock_time_t interval, clock_time_t slack)
+{
+   timer_set(&et->timer, interval);
+   et->timer.start -= CLOCK_STEP;
+#if ETIMER_CONF_SLACK
+   et->slack = (slack > ETIMER_MAX_SLACK) ? ETIMER_MAX_SLACK : slack;
+#else
+   (void)slack;
+#endif
+#if ETIMER_CONF_PERIODIC
+   et->periodic = 0;
+#endif
+   add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+#if ETIMER_CONF_PERIODIC
+void etimer_set_periodic(struct etimer *et, clock_time_t period, uint8_t policy)
+{
+   etimer_set_periodic_at(et, clock_time() + period, period, policy);
+}
+/*---------------------------------------------------------------------------*/
+void etimer_set_periodic_at(struct etimer *et, clock_time_t deadline, clock_time_t period, uint8_t policy)
+{
+   assert( period != 0 );
+   assert( policy == ETIMER_PERIODIC_SKIP  ||  policy == ETIMER_PERIODIC_BURST  ||  policy == ETIMER_PERIODIC_REPORT );
+
+   et->timer.start    = deadline - CLOCK_STEP - period;
+   et->timer.interval = period;
+#if ETIMER_CONF_SLACK
+   et->slack = 0;
+#endif
+   et->periodic = policy;
+   et->overruns = 0;
+   add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+uint16_t etimer_overruns(struct etimer *et)
+{
+   uint16_t n = et->overruns;
+
+   et->overruns = 0;
+   return n;
+}
+#endif
+/*---------------------------------------------------------------------------*/
 void etimer_reset(struct etimer *et)
 {
    timer_reset(&et->timer);
@@ -208,10 +1050,14 @@ void etimer_reset_next(struct etimer *et)
     if (et->timer.interval == 0) {
         // actually this should not happen
         timer_restart( &et->timer );
+        et->timer.start -= CLOCK_STEP;
     }
     else {
-        while (timer_expired(&et->timer)) {
-            timer_reset(&et->timer);
+        clock_time_t now = etimer_clock();
+
+        // first period boundary after now, O(1)
+        if (CLOCK_A_GE_B(now, et->timer.start + et->timer.interval)) {
+            et->timer.start += ((now - et->timer.start) / et->timer.interval) * et->timer.interval;
         }
     }
     add_timer(et);
@@ -220,6 +1066,7 @@ void etimer_reset_next(struct etimer *et)
 void etimer_restart(struct etimer *et)
 {
    timer_restart(&et->timer);
+   et->timer.start -= CLOCK_STEP;
    add_timer(et);
 }
 /*---------------------------------------------------------------------------*/
@@ -237,44 +1084,129 @@ int16_t etimer_expired(struct etimer *et)
 /*---------------------------------------------------------------------------*/
 clock_time_t etimer_expiration_time(struct etimer *et)
 {
-   return et->timer.start + et->timer.interval;
+   return expiration(et) + CLOCK_STEP;
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t etimer_start_time(struct etimer *et)
 {
-   return et->timer.start;
+   return et->timer.start + CLOCK_STEP;
 }
 /*---------------------------------------------------------------------------*/
 int16_t etimer_pending(void)
 {
-   return timerlist != NULL;
+   return etimer_next_armed(NULL) != NULL;
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t etimer_next_expiration_time(void)
 {
-   return etimer_pending() ? next_expiration : 0;
+#if ETIMER_CONF_DEFERRED_UPDATE
+   etimer_sync();
+#endif
+   return etimer_pending() ? next_expiration + CLOCK_STEP : 0;
 }
 /*---------------------------------------------------------------------------*/
 void etimer_stop(struct etimer *et)
 {
-   struct etimer **t;
-
-   for (t = &timerlist; *t != NULL; t = &((*t)->next)) {
-      if (*t == et) {
-         *t = et->next;
-         break;
-      }
+   if (queue_contains(et)) {
+      unlink_timer(et);
    }
+#if ETIMER_CONF_DIRECT_DELIVERY
+   process_cancel_timer(et);
+#endif
 
-   /* Remove the next pointer from the item to be removed. */
-   et->next = NULL;
    /* Set the timer as expired */
    et->p = PROCESS_NONE;
 }
 /*---------------------------------------------------------------------------*/
+static void etimer64_leg(struct etimer64 *et, clock_time64_t now)
+/**
+ * Arm the embedded etimer for the next part of the interval.  The leg
+ * starts at the 64 bit \a now, so the last leg ends exactly at the deadline.
+ */
+{
+   clock_time64_t left = et->deadline - now;
+
+   et->et.timer.start = (clock_time_t)now;
+   et->et.timer.interval = (left < ETIMER64_MAX_LEG) ? (clock_time_t)left : ETIMER64_MAX_LEG;
+#if ETIMER_CONF_SLACK
+   et->et.slack = 0;
+#endif
+#if ETIMER_CONF_PERIODIC
+   et->et.periodic = 0;
+#endif
+   add_timer(&et->et);
+}
+/*---------------------------------------------------------------------------*/
+void etimer64_set(struct etimer64 *et, clock_time64_t interval)
+{
+   clock_time64_t now = clock_time64() - CLOCK_STEP64;
+
+   et->deadline = now + interval;
+   etimer64_leg(et, now);
+}
+/*---------------------------------------------------------------------------*/
+int16_t etimer64_expired(struct etimer64 *et)
+{
+   clock_time64_t now;
+
+   if ( !etimer_expired(&et->et)) {
+      return 0;
+   }
+   now = clock_time64() - CLOCK_STEP64;
+   if (CLOCK64_A_GE_B(now, et->deadline)) {
+      return 1;
+   }
+   etimer64_leg(et, now);
+   return 0;
+}
+/*---------------------------------------------------------------------------*/
+clock_time64_t etimer64_expiration_time(struct etimer64 *et)
+{
+   return et->deadline + CLOCK_STEP64;
+}
+/*---------------------------------------------------------------------------*/
+void etimer64_stop(struct etimer64 *et)
+{
+   etimer_stop(&et->et);
+   et->deadline = 0;
+}
+/*---------------------------------------------------------------------------*/
+struct etimer *etimer_first_owned(struct process *p)
+{
+   return p->timers;
+}
+/*---------------------------------------------------------------------------*/
 struct etimer *etimer_timerlist( void )
 {
-   return timerlist;
+   return etimer_next_armed(NULL);
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_STATS
+uint32_t etimer_wakeups(void)
+{
+   return etimers.wakeups;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t etimer_wakeups_saved(void)
+{
+   return etimers.coalesced;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t etimer_alarm_updates(void)
+{
+   return etimers.alarms;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t etimer_alarm_updates_saved(void)
+{
+   return etimers.alarms_saved;
+}
+/*---------------------------------------------------------------------------*/
+void etimer_stats_reset(void)
+{
+   etimers.wakeups = etimers.coalesced = 0;
+   etimers.alarms = etimers.alarms_saved = 0;
 }
 /*---------------------------------------------------------------------------*/
+#endif /* PROCESS_CONF_STATS */
 /** @} */
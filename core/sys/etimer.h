@@ -73,14 +73,54 @@
  * A timer.
  *
  * This structure is used for declaring a timer. The timer must be set
- * with etimer_set() before it can be used.
+ * with etimer_set() before it can be used.  It must be zero initialized,
+ * as static variables are, or passed to etimer_init() before its first
+ * use.
  *
  * \hideinitializer
  */
 struct etimer {
   struct timer timer;
+#if ETIMER_CONF_BACKEND == ETIMER_BACKEND_HEAP
+  struct etimer *next;          /**< next timer in the spill list, see ETIMER_CONF_HEAP_SIZE */
+  struct process *p;
+  struct etimer *owned_next;    /**< next armed timer of the same process */
+  struct etimer **owned_pprev;
+#if ETIMER_CONF_DIRECT_DELIVERY
+  struct etimer *expired_next;  /**< next timer awaiting delivery, see process_post_timer() */
+  struct process *expired_p;    /**< receiver of the undelivered PROCESS_EVENT_TIMER, NULL if none */
+  uint16_t expired_seq;         /**< position of the delivery in the event queue */
+#endif
+  uint16_t index;               /**< position in the timer heap */
+#if ETIMER_CONF_SLACK
+  uint16_t slack;               /**< the timer may be delivered up to this many ticks late */
+#endif
+#if ETIMER_CONF_PERIODIC
+  uint8_t periodic;             /**< overrun policy of a periodic timer, 0 for a one-shot timer */
+  uint16_t overruns;            /**< periods skipped with ETIMER_PERIODIC_REPORT */
+#endif
+#else
   struct etimer *next;
   struct process *p;
+  struct etimer **pprev;        /**< link to this timer in the timer list */
+  struct etimer *owned_next;    /**< next armed timer of the same process */
+  struct etimer **owned_pprev;
+#if ETIMER_CONF_DIRECT_DELIVERY
+  struct etimer *expired_next;  /**< next timer awaiting delivery, see process_post_timer() */
+  struct process *expired_p;    /**< receiver of the undelivered PROCESS_EVENT_TIMER, NULL if none */
+  uint16_t expired_seq;         /**< position of the delivery in the event queue */
+#endif
+#if ETIMER_CONF_BACKEND == ETIMER_BACKEND_WHEEL
+  uint16_t bucket;              /**< 1 + wheel slot, overflow or due list holding the timer, 0 if not armed */
+#endif
+#if ETIMER_CONF_SLACK
+  uint16_t slack;               /**< the timer may be delivered up to this many ticks late */
+#endif
+#if ETIMER_CONF_PERIODIC
+  uint8_t periodic;             /**< overrun policy of a periodic timer, 0 for a one-shot timer */
+  uint16_t overruns;            /**< periods skipped with ETIMER_PERIODIC_REPORT */
+#endif
+#endif
 };
 
 /**
@@ -88,6 +128,20 @@ struct etimer {
  * @{
  */
 
+/**
+ * \brief      Initialize an event timer.
+ * \param et   A pointer to the event timer
+ *
+ *             Marks the timer as not armed.  Timers in static memory
+ *             and in the frames of coroutine processes are zero
+ *             initialized and need not be initialized.  A timer in
+ *             other reused memory, e.g. on the stack or the heap, must
+ *             be initialized before it is used for the first time.
+ *             The wheel backend tells armed timers by their links and
+ *             relies on this.
+ */
+void etimer_init(struct etimer *et);
+
 /**
  * \brief      Set an event timer.
  * \param et   A pointer to the event timer
@@ -98,9 +152,80 @@ struct etimer {
  *             the event PROCESS_EVENT_TIMER will be posted to the
  *             process that called the etimer_set() function.
  *
+ *             The number of armed timers is not limited.  With
+ *             ETIMER_BACKEND_HEAP only ETIMER_CONF_HEAP_SIZE timers
+ *             per scheduler context are kept in the heap, further
+ *             timers wait in a sorted list and cost O(n) each until
+ *             the heap has room for them.
  */
 void etimer_set(struct etimer *et, clock_time_t interval);
 
+/**
+ * \brief      Set an event timer which may be delivered late.
+ * \param et   A pointer to the event timer
+ * \param interval The interval before the timer expires.
+ * \param slack Tolerance in clock ticks, at most ETIMER_MAX_SLACK.
+ *
+ *             Like etimer_set(), but the timer may be delivered up to
+ *             \a slack ticks after its expiration.  The wake-up time
+ *             is chosen as late as the tolerance of all timers allows,
+ *             so timers with nearby deadlines share one wake-up instead
+ *             of waking the CPU separately.  A timer is never delivered
+ *             early.  etimer_reset(), etimer_restart() and
+ *             etimer_adjust() keep the slack, etimer_set() clears it.
+ *
+ *             Without ETIMER_CONF_SLACK the slack is ignored.
+ */
+void etimer_set_slack(struct etimer *et, clock_time_t interval, clock_time_t slack);
+
+#if ETIMER_CONF_PERIODIC
+/**
+ * \name Overrun policies of periodic event timers
+ * @{
+ */
+#define ETIMER_PERIODIC_SKIP    1   /**< missed periods are dropped */
+#define ETIMER_PERIODIC_BURST   2   /**< missed periods are delivered one per expiry pass until caught up */
+#define ETIMER_PERIODIC_REPORT  3   /**< missed periods are dropped and counted, see etimer_overruns() */
+/** @} */
+
+/**
+ * \brief      Set a periodic event timer.
+ * \param et   A pointer to the event timer
+ * \param period The period, must not be 0.
+ * \param policy What happens with periods missed during a stall,
+ *             one of ETIMER_PERIODIC_xxx.
+ *
+ *             PROCESS_EVENT_TIMER is posted every \a period ticks, the
+ *             first time \a period ticks from now.  The timer is
+ *             re-armed by the etimer module at the next period boundary
+ *             without drift, the boundary is computed in O(1) after a
+ *             stall.  The timer stays armed until etimer_stop(), so
+ *             etimer_expired() is false: wait for PROCESS_EVENT_TIMER
+ *             with \c data equal to \a et.
+ */
+void etimer_set_periodic(struct etimer *et, clock_time_t period, uint8_t policy);
+
+/**
+ * \brief      Set a periodic event timer with an absolute first deadline.
+ * \param et   A pointer to the event timer
+ * \param deadline The time of the first expiration.
+ * \param period The period, must not be 0.
+ * \param policy One of ETIMER_PERIODIC_xxx.
+ *
+ *             Like etimer_set_periodic(), but the period boundaries are
+ *             \a deadline + n * \a period.  A deadline in the past is
+ *             handled by the overrun policy.
+ */
+void etimer_set_periodic_at(struct etimer *et, clock_time_t deadline, clock_time_t period, uint8_t policy);
+
+/**
+ * \brief      Number of periods skipped with ETIMER_PERIODIC_REPORT.
+ * \param et   A pointer to the event timer
+ * \return     The periods skipped since the last call, the counter is cleared.
+ */
+uint16_t etimer_overruns(struct etimer *et);
+#endif
+
 /**
  * \brief      Reset an event timer with the same interval as was
  *             previously set.
@@ -201,11 +326,83 @@ int16_t etimer_expired(struct etimer *et);
  *             This function stops an event timer that has previously
  *             been set with etimer_set() or etimer_reset(). After
  *             this function has been called, the event timer will not
- *             emit any event when it expires.
- *
+ *             emit any event when it expires.  With
+ *             ETIMER_CONF_DIRECT_DELIVERY an expiry which has not been
+ *             delivered yet is dropped as well.
  */
 void etimer_stop(struct etimer *et);
 
+/**
+ * An event timer with 64 bit clock time.
+ *
+ * For intervals beyond \ref CLOCK_MAX_DELTA.  The embedded etimer is
+ * armed for legs of at most ETIMER64_MAX_LEG ticks, the end of each
+ * leg but the last one wakes the owner with PROCESS_EVENT_TIMER and
+ * etimer64_expired() arms the next one.  Wait for the timer with
+ * PROCESS_WAIT_EVENT_UNTIL(etimer64_expired(&t)).
+ *
+ * \hideinitializer
+ */
+struct etimer64 {
+  struct etimer et;
+  clock_time64_t deadline;    /* without the steps of clock_adjust() */
+};
+
+/** Longest leg of an etimer64, well within the range of CLOCK_A_LT_B() */
+#define ETIMER64_MAX_LEG  ((clock_time_t)(CLOCK_MAX_DELTA / 2))
+
+/**
+ * \brief      Set a 64 bit event timer.
+ * \param et   A pointer to the event timer
+ * \param interval The interval before the timer expires.
+ *
+ *             Like etimer_set(), the calling process becomes the owner.
+ */
+void etimer64_set(struct etimer64 *et, clock_time64_t interval);
+
+/**
+ * \brief      Check if a 64 bit event timer has expired.
+ * \param et   A pointer to the event timer
+ * \return     Non-zero if the timer has expired, zero otherwise.
+ *
+ *             Arms the next leg if the current one has ended before
+ *             the deadline, so it must be called by the owner.  A
+ *             stopped timer is expired.
+ */
+int16_t etimer64_expired(struct etimer64 *et);
+
+/**
+ * \brief      Get the expiration time of a 64 bit event timer.
+ * \param et   A pointer to the event timer
+ * \return     The expiration time, see clock_time64().
+ */
+clock_time64_t etimer64_expiration_time(struct etimer64 *et);
+
+/**
+ * \brief      Stop a pending 64 bit event timer.
+ * \param et   A pointer to the event timer
+ */
+void etimer64_stop(struct etimer64 *et);
+
+/**
+ * \brief      Number of armed event timers of a process.
+ * \param p    The process.
+ *
+ *             Each process keeps a list of its armed timers, so this is
+ *             O(1).  Useful for diagnostics.
+ */
+#define etimer_armed_count(p)  ((p)->ntimers)
+
+/**
+ * \brief      First armed event timer of a process.
+ * \param p    The process.
+ * \return     The timer or NULL if \a p has no armed timer.
+ *
+ *             The other timers of \a p follow via the \c owned_next
+ *             member, in no particular order.
+ */
+struct etimer *etimer_first_owned(struct process *p);
+
 /** @} */
 
 /**
@@ -219,10 +416,34 @@ void etimer_stop(struct etimer *et);
  *             This function is used to inform the event timer module
  *             that the system clock has been updated. Typically, this
  *             function would be called from the timer interrupt
- *             handler when the clock has ticked.
+ *             handler when the clock has ticked.  With
+ *             ETIMER_CONF_SCHEDULER_EXPIRY process_run() compares the
+ *             clock itself and the call is optional.
  */
 void etimer_request_poll(void);
 
+/**
+ * \brief      Deliver the expired event timers of the selected context.
+ *
+ *             Run by etimer_process when it is polled and, with
+ *             ETIMER_CONF_SCHEDULER_EXPIRY, by process_run() as soon as
+ *             the next expiration time is reached.
+ */
+void etimer_run(void);
+
+#if ETIMER_CONF_DEFERRED_UPDATE
+/**
+ * \brief      Recompute the wake-up time after changes of the timer queue.
+ *
+ *             Setting, resetting and delivering timers only marks the
+ *             wake-up time as stale, process_run() calls this function
+ *             once per round to program the clock with clock_update().
+ *             Call it before sleeping if timers were set outside of
+ *             process_run().
+ */
+void etimer_sync(void);
+#endif
+
 /**
  * \brief      Check if there are any non-expired event timers.
  * \return     True if there are active event timers, false if there are
@@ -240,20 +461,75 @@ int16_t etimer_pending(void);
  *	       returns 0.
  *
  *             This functions returns next expiration time of all
- *             pending event timers.
+ *             pending event timers.  With timer slack this is the
+ *             shared wake-up time, i.e. the latest time at which all
+ *             timers due until then are still within their slack.
  */
 clock_time_t etimer_next_expiration_time(void);
 
 /**
  * \brief      Return pointer to the internal etimer list
- * \return     first entry of the etimer list
+ * \return     first armed timer, see etimer_next_armed()
  */
 struct etimer *etimer_timerlist( void );
 
+/**
+ * \brief      Iterate over the armed event timers of the selected context.
+ * \param et   The previous timer, NULL for the first one.
+ * \return     The next armed timer or NULL.
+ *
+ *             Only the list backend returns the timers in the order of
+ *             their expiration.  The queue must not be changed during
+ *             the iteration.
+ */
+struct etimer *etimer_next_armed(struct etimer *et);
+
+#if PROCESS_CONF_CONTEXTS
+/**
+ * \brief      Set up the etimer process of the selected context.  Called by process_init().
+ */
+void etimer_context_init(void);
+
+/**
+ * \brief      The etimer process of the selected context, etimer_process in
+ *             the default context.
+ *
+ *             Started with process_start( etimer_context_process(), NULL )
+ *             after process_init().
+ */
+struct process *etimer_context_process(void);
+#endif
+
 /** @} */
 
+#if PROCESS_CONF_STATS
+/**
+ * \name Statistics of the selected context
+ * @{
+ */
+/** Number of expiry passes which delivered timers, i.e. timer wake-ups */
+uint32_t etimer_wakeups(void);
+/** Number of timer deadlines delivered together with an earlier deadline, i.e. wake-ups saved */
+uint32_t etimer_wakeups_saved(void);
+/** Number of wake-up time computations, i.e. calls of clock_update() */
+uint32_t etimer_alarm_updates(void);
+/** Number of timer queue changes merged into a later wake-up time computation */
+uint32_t etimer_alarm_updates_saved(void);
+/** Clear the statistics above */
+void etimer_stats_reset(void);
+/** @} */
+#endif
+
+/** The etimer process of the default context */
 PROCESS_NAME(etimer_process);
 
+#if PROCESS_CONF_CONTEXTS
+   /* each scheduler context has its own etimer process, for the core */
+   #define ETIMER_PROCESS (*PROCESS_CTX->etimer_process)
+#else
+   #define ETIMER_PROCESS etimer_process
+#endif
+
 
 #ifdef __cplusplus
     }
@@ -0,0 +1,467 @@
+/**
+ * \addtogroup hibernate
+ * @{
+ */
+
+/**
+ * \file
+ * Hibernation of the scheduler state.
+ *
+ * The snapshot is a header followed by records for the processes, the
+ * events, the etimers, the ctimers and the application regions, each
+ * copied with memcpy() so the buffer need not be aligned.  Timers are
+ * stored with their remaining time relative to the time of the snapshot,
+ * which makes the snapshot independent of the clock after wake up.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "sys/hibernate.h"
+
+#if !defined(CONTIKI_HIBERNATE_DEBUGPRINTF)
+   #define CONTIKI_HIBERNATE_DEBUGPRINTF(...)
+#endif
+
+#define HIBERNATE_MAGIC    0x4869u     /* "Hi" */
+
+struct hibernate_header {
+  uint16_t magic;
+  uint16_t size;                      /**< size of the snapshot including the header */
+  uint16_t check;                     /**< checksum of the records */
+  uint16_t nprocs, nevents, nexpired, ntimers, nctimers, nregions;
+  uint32_t build;                     /**< identifies the firmware image */
+};
+
+struct proc_record {
+  struct process *p;
+  struct pt_sem *sem_owning;
+  lc_t lc;
+  uint8_t needspoll;
+  uint8_t paused;
+  uint16_t pause_offset;              /**< number of saved events in front of the pause */
+#if PROCESS_CONF_LAZY_START
+  uint8_t lazy;
+  process_data_t lazy_arg;
+#endif
+};
+
+struct event_record {
+  struct process *p;
+  process_data_t data;
+  process_event_t ev;
+};
+
+struct timer_record {
+  struct etimer *et;
+  struct process *p;
+  clock_time_t remaining;
+  clock_time_t interval;
+#if ETIMER_CONF_SLACK
+  uint16_t slack;
+#endif
+#if ETIMER_CONF_PERIODIC
+  uint8_t periodic;
+  uint16_t overruns;
+#endif
+};
+
+struct ctimer_record {
+  struct ctimer *c;
+  struct process *p;
+  void (*f)(void *);
+  void *ptr;
+  clock_time_t remaining;
+  clock_time_t interval;
+};
+
+static struct hibernate_region *regions;
+static uint8_t buffer[HIBERNATE_CONF_SIZE];
+
+/*---------------------------------------------------------------------------*/
+/*
+ * Identifies the firmware image, snapshots of other images contain
+ * invalid addresses.
+ */
+static uint32_t build_id(void)
+{
+#ifdef HIBERNATE_CONF_BUILD_ID
+   return HIBERNATE_CONF_BUILD_ID;
+#else
+   return hibernate_port_build_id();
+#endif
+}
+/*---------------------------------------------------------------------------*/
+/* Fletcher-16 */
+static uint16_t checksum(const uint8_t *p, uint16_t len)
+{
+   uint16_t a = 0, b = 0;
+
+   while (len-- != 0) {
+      a = (a + *p++) % 255;
+      b = (b + a) % 255;
+   }
+   return (uint16_t)((b << 8) | a);
+}
+/*---------------------------------------------------------------------------*/
+/* Remaining time of a timer at \a now, zero if it has expired. */
+static clock_time_t remaining(const struct timer *t, clock_time_t now)
+{
+   clock_time_t expiry = t->start + t->interval;
+
+   return CLOCK_A_LT_B(now, expiry) ? (clock_time_t)(expiry - now) : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Append \a len bytes to the snapshot, returns zero if it does not fit. */
+static int16_t put(uint8_t *buf, uint16_t size, uint16_t *pos, const void *rec, uint16_t len)
+{
+   if (len > size - *pos) {
+      return 0;
+   }
+   memcpy(buf + *pos, rec, len);
+   *pos += len;
+   return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* the events for the service processes are recreated from the timer records */
+static int16_t is_saved(const struct process_queued_event *e)
+{
+   return e->p != PROCESS_ZOMBIE  &&  e->p != &ETIMER_PROCESS  &&  e->p != &CTIMER_PROCESS;
+}
+/*---------------------------------------------------------------------------*/
+void hibernate_add_region(struct hibernate_region *r)
+{
+   struct hibernate_region **q;
+
+   for (q = &regions;  *q != NULL;  q = &(*q)->next) {
+      if (*q == r) {
+         return;
+      }
+   }
+   r->next = NULL;
+   *q = r;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t hibernate_save(void *buf, uint16_t size)
+{
+   struct hibernate_header h;
+   uint8_t *b = (uint8_t *)buf;
+   uint16_t pos = sizeof(h);
+   clock_time_t now = clock_time() - CLOCK_STEP;    // time base of the etimers
+   struct process *p;
+   struct etimer *et;
+   struct ctimer *c;
+   struct hibernate_region *r;
+   struct process_queued_event e;
+   uint16_t i;
+
+   assert( !CONTIKI_IN_ISR() );
+
+   if (size < sizeof(h)) {
+      return 0;
+   }
+   memset(&h, 0, sizeof(h));
+
+   for (p = process_list;  p != NULL;  p = p->next) {
+      struct proc_record pr;
+
+#if PROCESS_CONF_CHILDREN
+      if (p->child != NULL) {
+         CONTIKI_HIBERNATE_DEBUGPRINTF("hibernate: '%s' has a running child\n", PROCESS_NAME_STRING(p));
+         return 0;
+      }
+#endif
+      memset(&pr, 0, sizeof(pr));
+      pr.p          = p;
+      pr.sem_owning = p->sem_owning;
+      pr.lc         = p->pt.lc;
+      pr.needspoll  = p->needspoll;
+#if PROCESS_CONF_LAZY_START
+      pr.lazy       = p->lazy;
+      pr.lazy_arg   = p->lazy_arg;
+#endif
+#if PROCESS_PAUSE_QUEUE
+      pr.paused       = p->paused;
+      for (i = 0;  p->paused  &&  i < (uint16_t)(p->pause_seq - PROCESS_CTX->deliver_seq);  ++i) {
+         process_event_peek(i, &e);
+         pr.pause_offset += is_saved(&e);
+      }
+#endif
+      if ( !put(b, size, &pos, &pr, sizeof(pr))) {
+         return 0;
+      }
+      ++h.nprocs;
+   }
+
+   for (i = 0;  process_event_peek(i, &e);  ++i) {
+      struct event_record er;
+
+      if ( !is_saved(&e)) {
+         continue;
+      }
+      er.p    = e.p;
+      er.data = e.data;
+      er.ev   = e.ev;
+      if ( !put(b, size, &pos, &er, sizeof(er))) {
+         return 0;
+      }
+      ++h.nevents;
+   }
+#if PROCESS_CONF_MAILBOXES
+   for (p = process_list;  p != NULL;  p = p->next) {
+      if (p == &ETIMER_PROCESS  ||  p == &CTIMER_PROCESS) {
+         continue;
+      }
+      for (i = 0;  i < p->mbox.n;  ++i) {
+         const struct process_mail *m = &p->mbox.slots[(p->mbox.first + i) & p->mbox.mask];
+         struct event_record er;
+
+         er.p    = p;
+         er.data = m->data;
+         er.ev   = m->ev;
+         if ( !put(b, size, &pos, &er, sizeof(er))) {
+            return 0;
+         }
+         ++h.nevents;
+      }
+   }
+#endif
+#if ETIMER_CONF_DIRECT_DELIVERY
+   /* undelivered timers, those of ctimer_process expire again with their ctimer */
+   for (et = PROCESS_CTX->expired_head;  et != NULL;  et = et->expired_next) {
+      struct event_record er;
+
+      if (et->expired_p == &CTIMER_PROCESS) {
+         continue;
+      }
+      er.p    = et->expired_p;
+      er.data = et;
+      er.ev   = PROCESS_EVENT_TIMER;
+      if ( !put(b, size, &pos, &er, sizeof(er))) {
+         return 0;
+      }
+      ++h.nexpired;
+   }
+#endif
+
+   /* the timers of ctimer_process are saved as ctimers */
+   for (et = etimer_next_armed(NULL);  et != NULL;  et = etimer_next_armed(et)) {
+      struct timer_record tr;
+
+      if (et->p == &CTIMER_PROCESS) {
+         continue;
+      }
+      tr.et        = et;
+      tr.p         = et->p;
+      tr.remaining = remaining(&et->timer, now);
+      tr.interval  = et->timer.interval;
+#if ETIMER_CONF_SLACK
+      tr.slack     = et->slack;
+#endif
+#if ETIMER_CONF_PERIODIC
+      tr.periodic  = et->periodic;
+      tr.overruns  = et->overruns;
+#endif
+      if ( !put(b, size, &pos, &tr, sizeof(tr))) {
+         return 0;
+      }
+      ++h.ntimers;
+   }
+
+   for (c = (struct ctimer *)PROCESS_CTX->ctimer_list;  c != NULL;  c = c->next) {
+      struct ctimer_record cr;
+
+      cr.c         = c;
+      cr.p         = c->p;
+      cr.f         = c->f;
+      cr.ptr       = c->ptr;
+      cr.remaining = remaining(&c->etimer.timer, now);
+      cr.interval  = c->etimer.timer.interval;
+      if ( !put(b, size, &pos, &cr, sizeof(cr))) {
+         return 0;
+      }
+      ++h.nctimers;
+   }
+
+   for (r = regions;  r != NULL;  r = r->next) {
+      if ( !put(b, size, &pos, &r->size, sizeof(r->size))  ||  !put(b, size, &pos, r->ptr, r->size)) {
+         return 0;
+      }
+      ++h.nregions;
+   }
+
+   h.magic = HIBERNATE_MAGIC;
+   h.size  = pos;
+   h.check = checksum(b + sizeof(h), pos - sizeof(h));
+   h.build = build_id();
+   memcpy(b, &h, sizeof(h));
+
+   CONTIKI_HIBERNATE_DEBUGPRINTF("hibernate: saved %u procs, %u events, %u etimers, %u ctimers in %u bytes\n",
+                                 h.nprocs, h.nevents, h.ntimers, h.nctimers, pos);
+   return pos;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Check header and regions of the snapshot \a b before anything is
+ * changed, returns the position of the first region.
+ */
+static uint16_t validate(const uint8_t *b, uint16_t size, struct hibernate_header *h)
+{
+   struct hibernate_region *r;
+   uint16_t pos;
+   uint16_t n = 0;
+
+   if (size < sizeof(*h)) {
+      return 0;
+   }
+   memcpy(h, b, sizeof(*h));
+   if (h->magic != HIBERNATE_MAGIC  ||  h->size > size  ||  h->size < sizeof(*h)  ||
+       h->build != build_id()  ||  h->check != checksum(b + sizeof(*h), h->size - sizeof(*h))) {
+      return 0;
+   }
+
+   pos = sizeof(*h) + h->nprocs   * sizeof(struct proc_record)
+                    + (h->nevents + h->nexpired) * sizeof(struct event_record)
+                    + h->ntimers  * sizeof(struct timer_record)
+                    + h->nctimers * sizeof(struct ctimer_record);
+   for (r = regions;  r != NULL;  r = r->next, ++n) {
+      uint16_t len;
+
+      if (n == h->nregions  ||  pos + sizeof(len) > h->size) {
+         return 0;
+      }
+      memcpy(&len, b + pos, sizeof(len));
+      if (len != r->size  ||  pos + sizeof(len) + len > h->size) {
+         return 0;
+      }
+      pos += sizeof(len) + len;
+   }
+   if (n != h->nregions  ||  pos != h->size) {
+      return 0;
+   }
+   return sizeof(*h);
+}
+/*---------------------------------------------------------------------------*/
+/* Arm \a et in the context of \a p with the deadline, period and slack of the snapshot. */
+static void arm(struct etimer *et, struct process *p, clock_time_t rest, clock_time_t interval, clock_time_t slack)
+{
+   PROCESS_CONTEXT_BEGIN(p);
+   etimer_set_slack(et, rest, slack);
+   PROCESS_CONTEXT_END(p);
+
+   /* same expiry, but etimer_reset() continues with the original period */
+   et->timer.start   += rest - interval;
+   et->timer.interval = interval;
+}
+/*---------------------------------------------------------------------------*/
+int16_t hibernate_restore(const void *buf, uint16_t size, clock_time_t slept)
+{
+   const uint8_t *b = (const uint8_t *)buf;
+   struct hibernate_header h;
+   struct proc_record pr;
+   struct event_record er;
+   struct hibernate_region *r;
+   uint16_t pos, events_pos, i, j;
+
+   assert( !CONTIKI_IN_ISR() );
+   assert( PROCESS_CTX->ctimer_initialized );
+
+   pos = validate(b, size, &h);
+   if (pos == 0) {
+      CONTIKI_HIBERNATE_DEBUGPRINTF("hibernate: no valid snapshot\n");
+      return 0;
+   }
+
+   /* in reverse order, so that the process list keeps its order */
+   for (i = h.nprocs;  i-- != 0;  ) {
+      memcpy(&pr, b + pos + i * sizeof(pr), sizeof(pr));
+#if PROCESS_CONF_LAZY_START
+      if (pr.lazy) {
+         process_start_lazy(pr.p, pr.lazy_arg);
+         continue;
+      }
+#endif
+      if (process_start_restored(pr.p, pr.lc, pr.needspoll)) {
+         pr.p->sem_owning = pr.sem_owning;
+      }
+   }
+
+   /* events, with the pauses inserted at their position in the queue */
+   events_pos = pos + h.nprocs * sizeof(pr);
+   for (j = 0;  j <= h.nevents;  ++j) {
+#if PROCESS_PAUSE_QUEUE
+      for (i = 0;  i < h.nprocs;  ++i) {
+         memcpy(&pr, b + pos + i * sizeof(pr), sizeof(pr));
+         if (pr.paused  &&  (pr.pause_offset == j)) {
+            PROCESS_CONTEXT_BEGIN(pr.p);
+            process_pause();
+            PROCESS_CONTEXT_END(pr.p);
+         }
+      }
+#endif
+      if (j < h.nevents) {
+         memcpy(&er, b + events_pos + j * sizeof(er), sizeof(er));
+         process_post(er.p, er.ev, er.data);
+      }
+   }
+   pos = events_pos + h.nevents * sizeof(er);
+
+#if ETIMER_CONF_DIRECT_DELIVERY
+   for (i = 0;  i < h.nexpired;  ++i, pos += sizeof(er)) {
+      memcpy(&er, b + pos, sizeof(er));
+      process_post_timer(er.p, (struct etimer *)er.data);
+   }
+#endif
+
+   for (i = 0;  i < h.ntimers;  ++i, pos += sizeof(struct timer_record)) {
+      struct timer_record tr;
+
+      memcpy(&tr, b + pos, sizeof(tr));
+#if ETIMER_CONF_SLACK
+      arm(tr.et, tr.p, tr.remaining > slept ? tr.remaining - slept : 0, tr.interval, tr.slack);
+#else
+      arm(tr.et, tr.p, tr.remaining > slept ? tr.remaining - slept : 0, tr.interval, 0);
+#endif
+#if ETIMER_CONF_PERIODIC
+      tr.et->periodic = tr.periodic;
+      tr.et->overruns = tr.overruns;
+#endif
+   }
+
+   for (i = 0;  i < h.nctimers;  ++i, pos += sizeof(struct ctimer_record)) {
+      struct ctimer_record cr;
+      clock_time_t rest;
+
+      memcpy(&cr, b + pos, sizeof(cr));
+      rest = cr.remaining > slept ? cr.remaining - slept : 0;
+      ctimer_set_with_process(cr.c, rest, cr.f, cr.ptr, cr.p);
+      cr.c->etimer.timer.start   += rest - cr.interval;
+      cr.c->etimer.timer.interval = cr.interval;
+   }
+
+   for (r = regions;  r != NULL;  r = r->next) {
+      pos += sizeof(r->size);
+      memcpy(r->ptr, b + pos, r->size);
+      pos += r->size;
+   }
+
+   CONTIKI_HIBERNATE_DEBUGPRINTF("hibernate: restored %u procs, %u events, %u etimers, %u ctimers\n",
+                                 h.nprocs, h.nevents, h.ntimers, h.nctimers);
+   return 1;
+}
+/*---------------------------------------------------------------------------*/
+int16_t hibernate_suspend(void)
+{
+   uint16_t len = hibernate_save(buffer, sizeof(buffer));
+
+   return len != 0  &&  hibernate_port_write(buffer, len);
+}
+/*---------------------------------------------------------------------------*/
+int16_t hibernate_resume(clock_time_t slept)
+{
+   uint16_t len = hibernate_port_read(buffer, sizeof(buffer));
+
+   hibernate_port_clear();
+   return len != 0  &&  hibernate_restore(buffer, len, slept);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
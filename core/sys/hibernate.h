@@ -0,0 +1,169 @@
+/**
+ * \addtogroup sys
+ * @{
+ */
+
+/**
+ * \defgroup hibernate Hibernation
+ * @{
+ *
+ * Hibernation saves the state of the scheduler - running processes with
+ * their protothread continuations, queued events, etimers and ctimers -
+ * into a snapshot, which survives deep sleep in retained memory (or a
+ * file on the host).  After wake up hibernate_resume() restores this
+ * state instead of starting all processes again, so the INIT work of the
+ * processes is not repeated.  Timers are rebased to the new clock, i.e.
+ * they keep their remaining time minus the sleep duration.
+ *
+ * Boot sequence:
+ \code
+ clock_start();
+ process_init();
+ // allocate events exactly as on a cold boot
+ process_start( &etimer_process, NULL );
+ ctimer_init();
+ hibernate_add_region( &app_state_region );
+ if ( !hibernate_resume( slept_ticks )) {
+     // cold boot: start the application processes
+ }
+ \endcode
+ *
+ * Before deep sleep hibernate_suspend() is called from outside of
+ * process context (e.g. from loop()).
+ *
+ * Limitations:
+ * - the snapshot is only valid for the same firmware image, it contains
+ *   addresses of processes, timers and callbacks; the image is identified
+ *   by hibernate_port_build_id() or HIBERNATE_CONF_BUILD_ID
+ * - static variables of the processes are not part of the snapshot,
+ *   state which must survive has to be registered with
+ *   hibernate_add_region(); the etimers and ctimers are restored
+ * - processes which are running already at resume time (e.g.
+ *   etimer_process) are left alone
+ * - coroutine processes and processes with running child protothreads
+ *   cannot be hibernated
+ */
+
+/**
+ * \file
+ * Header file for hibernation of the scheduler state.
+ */
+
+#ifndef __HIBERNATE_H__
+#define __HIBERNATE_H__
+
+#include <stdint.h>
+#include "contiki.h"
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif //__cplusplus
+
+#ifndef HIBERNATE_CONF_SIZE
+/** Size of the snapshot buffer in bytes */
+#define HIBERNATE_CONF_SIZE   1024
+#endif
+
+#ifdef DOXYGEN
+/**
+ * Identifier of the firmware image stored with the snapshot, overrides
+ * hibernate_port_build_id().  Must change with every image, e.g. a
+ * version control hash or build number supplied by the build.
+ */
+#define HIBERNATE_CONF_BUILD_ID
+#endif
+
+/**
+ * A memory region of the application which is saved with the snapshot.
+ */
+struct hibernate_region {
+  struct hibernate_region *next;
+  void *ptr;
+  uint16_t size;
+};
+
+/**
+ * \brief      Register a memory region which is part of the snapshot.
+ * \param r    The region, must stay valid.
+ *
+ *             Regions must be registered in the same order before
+ *             hibernate_save() and hibernate_restore().
+ */
+void hibernate_add_region(struct hibernate_region *r);
+
+/**
+ * \brief      Save the state of the selected scheduler context.
+ * \param buf  Buffer for the snapshot.
+ * \param size Size of \a buf.
+ * \return     Size of the snapshot, 0 if \a buf is too small or the
+ *             state cannot be saved.
+ */
+uint16_t hibernate_save(void *buf, uint16_t size);
+
+/**
+ * \brief      Restore a snapshot into the selected scheduler context.
+ * \param buf  The snapshot.
+ * \param size Size of the snapshot.
+ * \param slept Time passed since hibernate_save() which is not covered by
+ *             clock_time(), e.g. the deep sleep duration, in clock ticks.
+ * \return     Non-zero if the snapshot was valid and has been restored.
+ */
+int16_t hibernate_restore(const void *buf, uint16_t size, clock_time_t slept);
+
+/**
+ * \brief      Save the state into the retained storage of the port.
+ * \return     Non-zero on success.
+ */
+int16_t hibernate_suspend(void);
+
+/**
+ * \brief      Restore the state from the retained storage of the port.
+ * \param slept Sleep duration in clock ticks, see hibernate_restore().
+ * \return     Non-zero if a snapshot has been restored, zero on a cold boot.
+ *
+ *             The retained snapshot is invalidated, so it is restored
+ *             only once.
+ */
+int16_t hibernate_resume(clock_time_t slept);
+
+/**
+ * \name Functions provided by the port
+ * @{
+ */
+
+/**
+ * \brief      Write a snapshot to retained storage.
+ * \return     Non-zero on success.
+ */
+int16_t hibernate_port_write(const void *buf, uint16_t len);
+
+/**
+ * \brief      Read the snapshot from retained storage.
+ * \return     Size of the snapshot, 0 if there is none.
+ */
+uint16_t hibernate_port_read(void *buf, uint16_t size);
+
+/**
+ * \brief      Invalidate the snapshot in retained storage.
+ */
+void hibernate_port_clear(void);
+
+/**
+ * \brief      Identifier of the running firmware image.
+ * \return     A hash of the whole image, differs between any two images.
+ *
+ *             Not used if HIBERNATE_CONF_BUILD_ID is defined.
+ */
+uint32_t hibernate_port_build_id(void);
+
+/** @} */
+
+#ifdef __cplusplus
+    }
+#endif //__cplusplus
+
+#endif /* __HIBERNATE_H__ */
+
+/** @} */
+/** @} */
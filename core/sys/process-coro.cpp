@@ -0,0 +1,183 @@
+/**
+ * \addtogroup processcoro
+ * @{
+ */
+
+/**
+ * \file
+ * Implementation of C++20 coroutine processes and their frame arena.
+ */
+
+#if defined(__cpp_impl_coroutine)
+
+#include <assert.h>
+#include <string.h>
+#include "sys/process-coro.h"
+
+#if !defined(CONTIKI_PROCESS_DEBUGPRINTF)
+   #define CONTIKI_PROCESS_DEBUGPRINTF(...)
+#endif
+
+/**
+ * Frame slots of the arena.  Alignment is that of the strictest fundamental type,
+ * which is what operator new would deliver.
+ */
+static union coro_frame {
+    union coro_frame *next_free;
+    max_align_t align;
+    unsigned char mem[CORO_CONF_FRAME_SIZE];
+} frames[CORO_CONF_NUM_FRAMES];
+
+static union coro_frame *free_frames;
+static bool arena_initialized;
+static size_t max_frame;
+
+/*---------------------------------------------------------------------------*/
+void *coro_arena_alloc(size_t size) noexcept
+{
+    union coro_frame *f;
+
+    if ( !arena_initialized) {
+        for (int i = 0;  i < CORO_CONF_NUM_FRAMES;  ++i) {
+            frames[i].next_free = free_frames;
+            free_frames = &frames[i];
+        }
+        arena_initialized = true;
+    }
+
+    if (size > max_frame) {
+        max_frame = size;
+    }
+
+    if (size > sizeof(union coro_frame)  ||  free_frames == NULL) {
+        CONTIKI_PROCESS_DEBUGPRINTF("process-coro: cannot allocate frame of %u bytes\n", (unsigned)size);
+        return NULL;
+    }
+    f = free_frames;
+    free_frames = f->next_free;
+
+    /* locals such as etimers start zero initialized, see etimer_init() */
+    memset(f, 0, size);
+    return f;
+}
+/*---------------------------------------------------------------------------*/
+void coro_arena_free(void *frame) noexcept
+{
+    union coro_frame *f = static_cast<union coro_frame *>(frame);
+
+    if (f != NULL) {
+        assert( f >= frames  &&  f < frames + CORO_CONF_NUM_FRAMES );
+        f->next_free = free_frames;
+        free_frames = f;
+    }
+}
+/*---------------------------------------------------------------------------*/
+size_t coro_arena_max_frame(void) noexcept
+{
+    return max_frame;
+}
+/*---------------------------------------------------------------------------*/
+bool coro_ctx::sem_awaiter::acquire(void *arg)
+/**
+ * Try to get the semaphore.  If this fails, register the current process as
+ * blocked, exactly as PT_SEM_WAIT() does.
+ */
+{
+    sem_awaiter *self = static_cast<sem_awaiter *>(arg);
+    struct pt_sem *sem = self->sem;
+
+    if (sem->count > 0) {
+        --sem->count;
+        assert( PROCESS_CURRENT()->sem_owning == NULL );
+        PROCESS_CURRENT()->sem_owning = sem;
+        sem->lastBlock = clock_time();
+        return true;
+    }
+
+    if (sem->firstBlocked == NULL) {
+        sem->firstBlocked = PROCESS_CURRENT();
+    }
+    else {
+        sem->unlockWithBroadcast = 1;
+    }
+    return false;
+}
+/*---------------------------------------------------------------------------*/
+coro_ctx::event_awaiter coro_ctx::sem_signal(struct pt_sem &sem)
+{
+    bool pause = false;
+
+    ++sem.count;
+    PROCESS_CURRENT()->sem_owning = NULL;
+    if (sem.firstBlocked != NULL) {
+        process_post( sem.firstBlocked, PROCESS_EVENT_SEMSIGNAL, &sem );
+        sem.firstBlocked = NULL;
+        pause = true;
+    }
+    else if (sem.unlockWithBroadcast) {
+        process_post( PROCESS_BROADCAST, PROCESS_EVENT_SEMSIGNAL, &sem );
+        sem.unlockWithBroadcast = 0;
+        pause = true;
+    }
+
+    if (pause) {
+        process_post( PROCESS_CURRENT(), PROCESS_EVENT_SEMSIGNAL, &sem );
+    }
+    return event_awaiter{ *this, !pause };
+}
+/*---------------------------------------------------------------------------*/
+void coro_state::destroy()
+{
+    if (task.handle) {
+        task.handle.destroy();
+        task.handle = nullptr;
+    }
+    ctx.wait_fn = NULL;
+}
+/*---------------------------------------------------------------------------*/
+int8_t coro_state::dispatch(process_event_t ev, process_data_t data, coro_task (*body)(coro_ctx &))
+/**
+ * Protothread replacement for coroutine processes: create the coroutine on
+ * PROCESS_EVENT_INIT, destroy it on PROCESS_EVENT_EXIT, otherwise resume
+ * it if the condition of the pending co_await is fulfilled.
+ */
+{
+    if (ev == PROCESS_EVENT_EXIT) {
+        destroy();
+        return PT_EXITED;
+    }
+
+    if (ev == PROCESS_EVENT_INIT) {
+        // a frame may be left over if the process has been exited without PROCESS_EVENT_EXIT
+        destroy();
+        task = body( ctx );
+        if ( !task.handle) {
+            CONTIKI_PROCESS_DEBUGPRINTF("process-coro: no frame for '%s'\n", PROCESS_NAME_STRING(PROCESS_CURRENT()));
+            return PT_EXITED;
+        }
+    }
+    else if ( !task.handle) {
+        return PT_EXITED;
+    }
+
+    ctx.ev   = ev;
+    ctx.data = data;
+    if (ctx.wait_fn != NULL  &&  !ctx.wait_fn( ctx.wait_arg )) {
+        return PT_YIELDED;
+    }
+    ctx.wait_fn = NULL;
+
+    task.handle.resume();
+    if (task.handle.done()) {
+        // exit before the frame is released, the exit hooks unlink the timers which live in it
+        process_exit( PROCESS_CURRENT() );
+        destroy();
+        return PT_ENDED;
+    }
+    return PT_YIELDED;
+}
+/*---------------------------------------------------------------------------*/
+
+#endif // defined(__cpp_impl_coroutine)
+
+/** @} */
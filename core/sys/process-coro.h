@@ -0,0 +1,252 @@
+/**
+ * \addtogroup process
+ * @{
+ */
+
+/**
+ * \defgroup processcoro Coroutine processes
+ *
+ * A coroutine process is a Contiki process whose body is a C++20
+ * coroutine instead of a protothread.  Local variables survive a wait,
+ * so they need not be static, and waits are written as \c co_await
+ * expressions instead of PROCESS_WAIT_xxx() macros.
+ *
+ * Coroutine processes are ordinary <tt>struct process</tt>es: they are
+ * started with process_start(), receive events via process_post() and
+ * process_poll() and are dispatched by process_run() exactly like
+ * protothread processes.  Coroutine frames are taken from a fixed
+ * arena (\ref CORO_CONF_NUM_FRAMES x \ref CORO_CONF_FRAME_SIZE bytes),
+ * there is no heap usage.
+ *
+ * Example:
+ \code
+CORO_PROCESS(blink, "Blink")
+{
+    struct etimer timer = {};             // no static required
+
+    for (;;) {
+        co_await ctx.sleep(timer, CLOCK_SECOND);
+        digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+    }
+}
+ \endcode
+ *
+ * \note Requires C++20 coroutine support (e.g. gcc >= 10 with \c -std=gnu++20).
+ *
+ * @{
+ */
+
+/**
+ * \file
+ * Header file for C++20 coroutine processes.
+ */
+
+#ifndef __PROCESS_CORO_H__
+#define __PROCESS_CORO_H__
+
+#if !defined(__cpp_impl_coroutine)
+    #error "process-coro.h requires C++20 coroutines, compile with -std=gnu++20"
+#endif
+
+#include <coroutine>
+#include <stddef.h>
+#include "contiki.h"
+#include "sys/pt-sem.h"
+
+#ifndef CORO_CONF_FRAME_SIZE
+/** Size of one coroutine frame slot in bytes.  Frames larger than this cannot be started. */
+#define CORO_CONF_FRAME_SIZE   256
+#endif
+
+#ifndef CORO_CONF_NUM_FRAMES
+/** Number of coroutine frame slots, i.e. maximum number of concurrently running coroutine processes. */
+#define CORO_CONF_NUM_FRAMES   4
+#endif
+
+/**
+ * Allocate a frame from the coroutine arena.
+ * \return  pointer to the frame or NULL if \a size is too big or the arena is exhausted
+ */
+void *coro_arena_alloc(size_t size) noexcept;
+
+/**
+ * Return a frame to the coroutine arena.
+ */
+void coro_arena_free(void *frame) noexcept;
+
+/**
+ * Largest frame size ever requested from the arena.  Useful to tune \ref CORO_CONF_FRAME_SIZE.
+ */
+size_t coro_arena_max_frame(void) noexcept;
+
+/**
+ * Return object of a coroutine process body.  Only used internally by CORO_PROCESS().
+ */
+struct coro_task {
+    struct promise_type {
+        coro_task get_return_object() noexcept
+        {
+            return coro_task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        static coro_task get_return_object_on_allocation_failure() noexcept { return coro_task{}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+
+        static void *operator new(size_t size) noexcept { return coro_arena_alloc(size); }
+        static void operator delete(void *frame) noexcept { coro_arena_free(frame); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * Context of a coroutine process.  The body of a CORO_PROCESS() receives
+ * a reference \c ctx to it, which provides the awaitables and the
+ * current event.
+ */
+struct coro_ctx {
+    /** Event which resumed the coroutine */
+    process_event_t ev;
+    /** Data of the event which resumed the coroutine */
+    process_data_t data;
+
+    /** Resume condition of the pending co_await, NULL if any event resumes */
+    bool (*wait_fn)(void *arg);
+    void *wait_arg;
+
+    /**
+     * Awaitable which suspends until the condition \a c is true.  \a c is
+     * evaluated on every event delivered to the process.  This is
+     * PROCESS_YIELD_UNTIL(), i.e. it suspends at least once.
+     */
+    template <class COND>
+    struct until_awaiter {
+        coro_ctx &ctx;
+        COND c;
+
+        static bool check(void *arg) { return static_cast<until_awaiter *>(arg)->c(); }
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) noexcept
+        {
+            ctx.wait_fn  = &check;
+            ctx.wait_arg = this;
+        }
+        process_event_t await_resume() const noexcept { return ctx.ev; }
+    };
+
+    /**
+     * Awaitable which suspends until the next event arrives, see PROCESS_WAIT_EVENT().
+     * \return the received event, the data is in \c ctx.data
+     */
+    struct event_awaiter {
+        coro_ctx &ctx;
+        bool ready = false;
+
+        bool await_ready() const noexcept { return ready; }
+        void await_suspend(std::coroutine_handle<>) noexcept { ctx.wait_fn = NULL; }
+        process_event_t await_resume() const noexcept { return ctx.ev; }
+    };
+
+    /**
+     * Awaitable for acquiring a protothread semaphore, see PT_SEM_WAIT().
+     */
+    struct sem_awaiter {
+        coro_ctx &ctx;
+        struct pt_sem *sem;
+
+        static bool acquire(void *arg);
+
+        bool await_ready() noexcept { return acquire(this); }
+        void await_suspend(std::coroutine_handle<>) noexcept
+        {
+            ctx.wait_fn  = &acquire;
+            ctx.wait_arg = this;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    /** Suspend until the next event, equivalent to PROCESS_WAIT_EVENT() */
+    event_awaiter wait_event() { return event_awaiter{ *this }; }
+
+    /** Suspend until the event \a ev arrives */
+    auto wait_event(process_event_t ev)
+    {
+        return wait_until( [this, ev]() { return this->ev == ev; } );
+    }
+
+    /** Suspend until condition \a c is true, equivalent to PROCESS_YIELD_UNTIL() */
+    template <class COND>
+    until_awaiter<COND> wait_until(COND c) { return until_awaiter<COND>{ *this, c }; }
+
+    /** Suspend until the already running etimer \a et has expired */
+    auto wait_timer(struct etimer &et)
+    {
+        return wait_until( [&et]() { return etimer_expired( &et ) != 0; } );
+    }
+
+    /** Set etimer \a et to \a interval and suspend until it has expired */
+    auto sleep(struct etimer &et, clock_time_t interval)
+    {
+        etimer_set( &et, interval );
+        return wait_timer( et );
+    }
+
+    /** Let other processes run before continuing, equivalent to PROCESS_PAUSE_STRICT() */
+    auto pause()
+    {
+        process_pause();
+        return wait_event( PROCESS_EVENT_CONTINUE );
+    }
+
+    /** Acquire the semaphore \a sem, equivalent to PT_SEM_WAIT() */
+    sem_awaiter sem_wait(struct pt_sem &sem) { return sem_awaiter{ *this, &sem }; }
+
+    /**
+     * Release the semaphore \a sem, equivalent to PT_SEM_SIGNAL().  If a
+     * blocked process has been woken up, the coroutine yields to let it run.
+     * The result must be awaited.
+     */
+    event_awaiter sem_signal(struct pt_sem &sem);
+};
+
+/**
+ * State of one coroutine process.  Only used internally by CORO_PROCESS().
+ */
+struct coro_state {
+    coro_ctx ctx;
+    coro_task task;
+
+    int8_t dispatch(process_event_t ev, process_data_t data, coro_task (*body)(coro_ctx &));
+    void destroy();
+};
+
+/**
+ * Define a coroutine process.
+ *
+ * Declares the <tt>struct process</tt> \a name (with debug name \a strname)
+ * and starts the definition of its body.  The body is a coroutine with the
+ * parameter <tt>coro_ctx &ctx</tt>.  It is created on PROCESS_EVENT_INIT,
+ * i.e. by process_start(), and the process exits when the body returns.
+ * On PROCESS_EVENT_EXIT the frame is destroyed, so destructors of local
+ * variables are run.
+ *
+ * \hideinitializer
+ */
+#define CORO_PROCESS(name, strname)                                         \
+    static coro_task coro_body_##name(coro_ctx &ctx);                       \
+    PROCESS(name, strname);                                                 \
+    PROCESS_THREAD(name, ev, data)                                          \
+    {                                                                       \
+        static coro_state state;                                            \
+        (void)process_pt;                                                   \
+        return state.dispatch( ev, data, &coro_body_##name );               \
+    }                                                                       \
+    static coro_task coro_body_##name(coro_ctx &ctx)
+
+#endif /* __PROCESS_CORO_H__ */
+
+/** @} */
+/** @} */
@@ -47,6 +47,14 @@
 #include "sys/process.h"
 #include "sys/clock.h"
 #include "sys/pt-sem.h"
+#include "sys/tasklet.h"
+#include <string.h>
+#if PROCESS_CONF_CONTEXTS
+   #include "sys/etimer.h"
+   #include "sys/ctimer.h"
+#elif ETIMER_CONF_DIRECT_DELIVERY  ||  ETIMER_CONF_SCHEDULER_EXPIRY  ||  ETIMER_CONF_DEFERRED_UPDATE
+   #include "sys/etimer.h"
+#endif
 
 #if !defined(CONTIKI_PROCESS_DEBUGPRINTF)
    #define CONTIKI_PROCESS_DEBUGPRINTF(...)
@@ -56,42 +64,137 @@
    #error "PROCESS_CONF_NUMEVENTS must be a power of 2"
 #endif
 
-/*
- * Pointer to the currently running process structure.
- */
-struct process *process_list = NULL;
-struct process *process_current = NULL;
+#if ETIMER_CONF_DIRECT_DELIVERY  &&  PROCESS_CONF_FAIRNESS
+   /* fair dispatching delivers queued events out of order, see do_timer() */
+   #error "ETIMER_CONF_DIRECT_DELIVERY cannot be combined with PROCESS_CONF_FAIRNESS"
+#endif
 
-static process_event_t lastevent;
+PROCESS_CONF_CONTEXT_STORAGE struct process *process_list;
+PROCESS_CONF_CONTEXT_STORAGE struct process *process_current;
 
-/**
- * Structure used for keeping the queue of active events.
- */
-struct event_data {
-   process_event_t ev;
-   process_data_t data;
-   struct process *p;
-};
+#if PROCESS_CONF_CONTEXTS
+   static struct process_event_slot default_events[PROCESS_CONF_NUMEVENTS];
+   struct process_context process_default_ctx = { .event_buf = default_events,
+                                                  .event_mask = PROCESS_CONF_NUMEVENTS - 1 };
+   PROCESS_CONF_CONTEXT_STORAGE struct process_context *process_ctx = &process_default_ctx;
 
-typedef uint16_t process_num_events_t;
+   #define events          (PROCESS_CTX->event_buf)
+   #define EVENTS_MASK     (PROCESS_CTX->event_mask)
+#else
+   struct process_context process_default_ctx;
+   static struct process_event_slot events[PROCESS_CONF_NUMEVENTS];
 
-static process_num_events_t nevents, fevent;
-static struct event_data events[PROCESS_CONF_NUMEVENTS];
+   #define EVENTS_MASK     (PROCESS_CONF_NUMEVENTS - 1)
+#endif
 
-#if PROCESS_CONF_STATS
-   process_num_events_t process_maxevents;
+#if PROCESS_CONF_COMPACT_EVENTS
+   #if PROCESS_CONF_MAX_PROCESSES > 254
+      #error "PROCESS_CONF_MAX_PROCESSES must not exceed 254"
+   #endif
+
+   #define process_table    (PROCESS_CTX->table)
+   #define INDEX_BROADCAST  0xff
+   #define INDEX_ZOMBIE     0xfe
+
+   static inline struct process *slot_process(const struct process_event_slot *s)
+   {
+      return s->p == INDEX_BROADCAST ? PROCESS_BROADCAST
+           : s->p == INDEX_ZOMBIE    ? PROCESS_ZOMBIE
+           :                           process_table[s->p];
+   }
+
+   static inline process_data_t slot_data(const struct process_event_slot *s)
+   {
+      process_data_t data;
+
+      memcpy(&data, s->data, sizeof(data));
+      return data;
+   }
+
+   static inline void slot_set(struct process_event_slot *s, process_event_t ev,
+                               process_data_t data, struct process *p)
+   {
+      s->ev = ev;
+      memcpy(s->data, &data, sizeof(data));
+      s->p = p == PROCESS_BROADCAST ? INDEX_BROADCAST : p->index;
+   }
+
+   #define slot_set_zombie(s)   ((s)->p = INDEX_ZOMBIE)
+#else
+   #define slot_process(s)      ((s)->p)
+   #define slot_data(s)         ((s)->data)
+   #define slot_set_zombie(s)   ((s)->p = PROCESS_ZOMBIE)
+
+   static inline void slot_set(struct process_event_slot *s, process_event_t ev,
+                               process_data_t data, struct process *p)
+   {
+      s->ev = ev;
+      s->data = data;
+      s->p = p;
+   }
 #endif
 
-static volatile uint16_t poll_requested;
+/* Exit hooks are code, so they are shared by all contexts */
+static struct process_exit_hook *exit_hooks;
+
+/*
+ * Shortcuts to the state of the selected context.
+ */
+#define lastevent       (PROCESS_CTX->lastevent)
+#define nevents         (PROCESS_CTX->nevents)
+#define fevent          (PROCESS_CTX->fevent)
+#define poll_requested  (PROCESS_CTX->poll_requested)
+#define initialized     (PROCESS_CTX->initialized)
+#if PROCESS_CONF_MAILBOXES
+   #define ready_head      (PROCESS_CTX->ready_head)
+   #define ready_tail      (PROCESS_CTX->ready_tail)
+   #define nmail           (PROCESS_CTX->nmail)
+   #define broadcast_turn  (PROCESS_CTX->broadcast_turn)
+#else
+   #define nmail           0
+#endif
 
-static bool initialized;
+typedef uint16_t process_num_events_t;
 
 #define PROCESS_STATE_NONE        0
 #define PROCESS_STATE_RUNNING     1
 #define PROCESS_STATE_CALLED      2
-#define PROCESS_STATE_EXITING     4
+#define PROCESS_STATE_EXITING     3
 
 static void call_process(struct process *p, process_event_t ev, process_data_t data);
+#if PROCESS_CONF_CHILDREN
+static int8_t run_thread(struct process *p, process_event_t ev, process_data_t data);
+#endif
+
+#if PROCESS_PAUSE_QUEUE
+   #define pause_head       (PROCESS_CTX->pause_head)
+   #define pause_tail       (PROCESS_CTX->pause_tail)
+   #define npaused          (PROCESS_CTX->npaused)
+#else
+   #define npaused          0
+#endif
+#if PROCESS_PAUSE_QUEUE  ||  ETIMER_CONF_DIRECT_DELIVERY
+   #define deliver_seq      (PROCESS_CTX->deliver_seq)
+#endif
+
+#if ETIMER_CONF_DIRECT_DELIVERY
+   #define expired_head     (PROCESS_CTX->expired_head)
+   #define expired_tail     (PROCESS_CTX->expired_tail)
+   #define nexpired         (PROCESS_CTX->nexpired)
+#else
+   #define nexpired         0
+#endif
+
+#if PROCESS_CONF_BUDGET
+   #define budget_start     (PROCESS_CTX->budget_start)
+#endif
+
+#if PROCESS_CONF_FAIRNESS
+   #define fair_blocked     (PROCESS_CTX->fair_blocked)
+   #define fair_dispatched  (PROCESS_CTX->fair_dispatched)
+
+   #define FAIR_WEIGHT(p)  ((p)->fair.weight != 0 ? (p)->fair.weight : 1)
+#endif
 
 /*---------------------------------------------------------------------------*/
 process_event_t process_alloc_event(void)
@@ -100,7 +203,11 @@ process_event_t process_alloc_event(void)
    return lastevent++;
 }
 /*---------------------------------------------------------------------------*/
-void process_start(struct process *p, void *arg)
+/*
+ * Put \a p on the process list and reset its scheduler state.  Returns
+ * zero if the process is running already.
+ */
+static int16_t link_process(struct process *p)
 {
    struct process *q;
 
@@ -114,27 +221,135 @@ void process_start(struct process *p, void *arg)
 
    /* If we found the process on the process list, we bail out. */
    if (q == p) {
-      return;
+      return 0;
    }
+#if PROCESS_CONF_COMPACT_EVENTS
+   {
+      uint8_t i;
+
+      for (i = 0;  i < PROCESS_CONF_MAX_PROCESSES  &&  process_table[i] != NULL;  ++i) {
+      }
+      assert( i < PROCESS_CONF_MAX_PROCESSES );
+      process_table[i] = p;
+      p->index = i;
+   }
+#endif
+
    /* Put on the procs list.*/
    p->next = process_list;
    process_list = p;
    p->state = PROCESS_STATE_RUNNING;
    p->sem_owning = NULL;
+   p->timers = NULL;
+   p->ntimers = 0;
    PT_INIT(&p->pt);
+#if PROCESS_CONF_CHILDREN
+   p->child = NULL;
+#endif
+#if PROCESS_PAUSE_QUEUE
+   p->paused = 0;
+#endif
+#if PROCESS_CONF_LAZY_START
+   p->lazy = 0;
+#endif
+
+#if PROCESS_CONF_MAILBOXES
+   assert( p->mbox.slots != NULL  &&  (p->mbox.mask & (p->mbox.mask + 1)) == 0 );
+#endif
+
+#if PROCESS_CONF_BUDGET
+   p->budget.total_us = 0;
+   p->budget.max_us   = 0;
+   p->budget.yields   = 0;
+   p->budget.overruns = 0;
+#endif
 
-   CONTIKI_PROCESS_DEBUGPRINTF("process: starting '%s'\n", p->name);
+#if PROCESS_CONF_FAIRNESS
+   p->fair.credits        = FAIR_WEIGHT(p);
+   p->fair.deferred       = 0;
+   p->fair.deferrals      = 0;
+   p->fair.dispatches     = 0;
+   p->fair.max_starvation = 0;
+#endif
+
+   return 1;
+}
+/*---------------------------------------------------------------------------*/
+void process_start(struct process *p, void *arg)
+{
+   if ( !link_process( p )) {
+      return;
+   }
+
+   CONTIKI_PROCESS_DEBUGPRINTF("process: starting '%s'\n", PROCESS_NAME_STRING(p));
 
    /* Post a synchronous initialization event to the process. */
    process_post_synch(p, PROCESS_EVENT_INIT, (process_data_t)arg);
 }
 /*---------------------------------------------------------------------------*/
+int16_t process_start_restored(struct process *p, lc_t lc, unsigned char needspoll)
+{
+   if ( !link_process( p )) {
+      return 0;
+   }
+
+   CONTIKI_PROCESS_DEBUGPRINTF("process: restoring '%s'\n", PROCESS_NAME_STRING(p));
+
+#if PROCESS_CONF_MAILBOXES
+   /* the mail is restored from the snapshot */
+   p->mbox.first = p->mbox.n = p->mbox.ready = 0;
+#endif
+   p->pt.lc = lc;
+   if (needspoll) {
+      process_poll( p );
+   }
+   return 1;
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_LAZY_START
+void process_start_lazy(struct process *p, void *arg)
+{
+   if ( !link_process( p )) {
+      return;
+   }
+
+   CONTIKI_PROCESS_DEBUGPRINTF("process: starting '%s' lazily\n", PROCESS_NAME_STRING(p));
+
+   p->lazy     = 1;
+   p->lazy_arg = (process_data_t)arg;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t process_lazy_pending(void)
+{
+   struct process *p;
+   uint16_t n = 0;
+
+   for (p = process_list;  p != NULL;  p = p->next) {
+      n += p->lazy;
+   }
+   return n;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+/*
+ * Let the services release the resources of the exiting process \a p.
+ * The hooks are idempotent.
+ */
+static void run_exit_hooks(struct process *p)
+{
+   struct process_exit_hook *h;
+
+   for (h = exit_hooks;  h != NULL;  h = h->next) {
+      h->f(p);
+   }
+}
+/*---------------------------------------------------------------------------*/
 static void exit_process(struct process *p, struct process *fromprocess)
 {
    register struct process *q;
    struct process *old_current = process_current;
 
-   CONTIKI_PROCESS_DEBUGPRINTF("process: exit_process '%s'\n", p->name);
+   CONTIKI_PROCESS_DEBUGPRINTF("process: exit_process '%s'\n", PROCESS_NAME_STRING(p));
 
    /* Make sure the process is in the process list before we try to exit it. */
    for (q = process_list;  q != p;  q = q->next) {
@@ -158,22 +373,49 @@ static void exit_process(struct process *p, struct process *fromprocess)
          p->sem_owning = NULL;
       }
 
+#if PROCESS_CONF_EXITED_EVENT
       /*
        * Post a synchronous event to all processes to inform them that
-       * this process is about to exit. This will allow services to
-       * deallocate state associated with this process.
+       * this process is about to exit.
        */
       for (q = process_list; q != NULL; q = q->next) {
          if (p != q) {
             call_process(q, PROCESS_EVENT_EXITED, (process_data_t)p);
          }
       }
+#endif
 
-      if (p->thread != NULL && p != fromprocess) {
+      /*
+       * Release the resources of the process while its state is intact,
+       * PROCESS_EVENT_EXIT may free the memory of its timers (coroutine frames).
+       */
+      run_exit_hooks(p);
+
+      /* a process which has not been initialized has nothing to clean up */
+      if (p->desc->thread != NULL && p != fromprocess
+#if PROCESS_CONF_LAZY_START
+          && !p->lazy
+#endif
+         ) {
          /* Post the exit event to the process that is about to exit. */
          process_current = p;
-         (void)p->thread(&p->pt, PROCESS_EVENT_EXIT, NULL);
+#if PROCESS_CONF_CHILDREN
+         (void)run_thread(p, PROCESS_EVENT_EXIT, NULL);
+#else
+         (void)p->desc->thread(&p->pt, PROCESS_EVENT_EXIT, NULL);
+#endif
+      }
+
+#if PROCESS_CONF_CHILDREN
+      /* abandon the children which are still running */
+      while (p->child != NULL) {
+         p->child->running = 0;
+         p->child = p->child->parent;
       }
+#endif
+
+      /* and those acquired while handling PROCESS_EVENT_EXIT */
+      run_exit_hooks(p);
 
       p->state = PROCESS_STATE_NONE;
    }
@@ -190,36 +432,160 @@ static void exit_process(struct process *p, struct process *fromprocess)
       }
    }
 
+#if PROCESS_PAUSE_QUEUE
+   /* Drop a pending pause, the list of paused processes is short */
+   if (p->paused) {
+      struct process *prev = NULL;
+
+      for (q = pause_head;  q != p;  q = q->pause_next) {
+         prev = q;
+      }
+      if (prev == NULL) {
+         pause_head = p->pause_next;
+      }
+      else {
+         prev->pause_next = p->pause_next;
+      }
+      if (pause_tail == p) {
+         pause_tail = prev;
+      }
+      p->paused = 0;
+      --npaused;
+   }
+#endif
+
+#if ETIMER_CONF_DIRECT_DELIVERY
+   /* Drop the undelivered timers */
+   {
+      struct etimer *et = expired_head;
+
+      while (et != NULL) {
+         struct etimer *next = et->expired_next;
+
+         if (et->expired_p == p) {
+            process_cancel_timer(et);
+         }
+         et = next;
+      }
+   }
+#endif
+
+#if PROCESS_CONF_MAILBOXES
+   /* Drop the mail, the process is removed lazily from the ready list */
+   if (p->mbox.n != 0) {
+      CONTIKI_PROCESS_DEBUGPRINTF("soft panic: exiting process has %d remaining events\n", p->mbox.n);
+      nmail -= p->mbox.n;
+      p->mbox.n = 0;
+   }
+#else
    {
       process_num_events_t n;
       process_num_events_t i = fevent;
       for (n = nevents; n > 0; n--) {
-         if (events[i].p == p) {
-            events[i].p = PROCESS_ZOMBIE;
+         if (slot_process(&events[i]) == p) {
+            slot_set_zombie(&events[i]);
             CONTIKI_PROCESS_DEBUGPRINTF("soft panic: exiting process has remaining event 0x%x\n",
                                         events[i].ev);
          }
-         i = (i + 1) & (PROCESS_CONF_NUMEVENTS - 1);
+         i = (i + 1) & EVENTS_MASK;
       }
    }
+#endif
+#if PROCESS_CONF_COMPACT_EVENTS
+   /* no event refers to the index any more */
+   process_table[p->index] = NULL;
+#endif
    process_current = old_current;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_CHILDREN
+/*
+ * Run the innermost child of \a p, or the process itself if it has no
+ * running child.  A newly spawned child is run immediately, an ended
+ * child resumes its parent with the same event.
+ */
+static int8_t run_thread(struct process *p, process_event_t ev, process_data_t data)
+{
+   for (;;) {
+      struct process_child *c = p->child;
+      int8_t ret;
+
+      if (c == NULL) {
+         ret = p->desc->thread(&p->pt, ev, data);
+         if (p->child == NULL  ||  ret >= PT_EXITED) {
+            return ret;
+         }
+      }
+      else {
+         ret = c->thread(&c->pt, ev, data);
+         if (p->child == c) {
+            if (ret < PT_EXITED) {
+               return ret;
+            }
+            c->running = 0;
+            p->child = c->parent;
+         }
+      }
+   }
+}
+/*---------------------------------------------------------------------------*/
+void process_child_start(struct process_child *child,
+                         PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t)),
+                         void *arg)
+{
+   struct process *p = process_current;
+
+   assert( p != NULL );
+
+   PT_INIT(&child->pt);
+   child->thread  = thread;
+   child->arg     = arg;
+   child->parent  = p->child;
+   child->running = 1;
+   p->child = child;
+}
+#endif
+/*---------------------------------------------------------------------------*/
 static void call_process(struct process *p, process_event_t ev, process_data_t data)
 {
    if (p->state == PROCESS_STATE_CALLED) {
-       CONTIKI_PROCESS_DEBUGPRINTF("process: process '%s' called again with event %d\n", p->name, ev);
+       CONTIKI_PROCESS_DEBUGPRINTF("process: process '%s' called again with event %d\n", PROCESS_NAME_STRING(p), ev);
+   }
+
+#if PROCESS_CONF_LAZY_START
+   if (p->lazy  &&  p->state == PROCESS_STATE_RUNNING) {
+      /* deliver the deferred PROCESS_EVENT_INIT first, see process_start_lazy() */
+      p->lazy = 0;
+      call_process(p, PROCESS_EVENT_INIT, p->lazy_arg);
    }
+#endif
 
-   if (p->state == PROCESS_STATE_RUNNING  &&  p->thread != NULL) {
+   if (p->state == PROCESS_STATE_RUNNING  &&  p->desc->thread != NULL) {
       int16_t ret;
+#if PROCESS_CONF_STATS
+      uint32_t init_start = 0;
+#endif
+#if PROCESS_CONF_BUDGET
+      /* a synchronous post runs within the budget of the caller */
+      uint32_t caller_start = budget_start;
+#endif
 
-      ////CONTIKI_PROCESS_DEBUGPRINTF("process: calling process '%s' with event %d\n", p->name, ev);
+      ////CONTIKI_PROCESS_DEBUGPRINTF("process: calling process '%s' with event %d\n", PROCESS_NAME_STRING(p), ev);
       process_current = p;
       p->state = PROCESS_STATE_CALLED;
+#if PROCESS_CONF_BUDGET
+      budget_start = clock_usecs();
+#endif
+#if PROCESS_CONF_STATS
+      if (ev == PROCESS_EVENT_INIT) {
+         init_start = clock_usecs();
+      }
+#endif
 
-#if 1  ||  defined(NDEBUG)                            // make it better!
-      ret = p->thread(&p->pt, ev, data);
+#if PROCESS_CONF_CHILDREN
+      ret = run_thread(p, ev, data);
+#elif 1  ||  defined(NDEBUG)                          // make it better!
+      ret = p->desc->thread(&p->pt, ev, data);
 #elif defined(__LC_ADDRLABELS_H__)
       {
          clock_time_t clock_start;
@@ -229,13 +595,13 @@ static void call_process(struct process *p, process_event_t ev, process_data_t d
 
          clock_start = clock_time();
          lc_start = p->pt.lc;
-         ret = p->thread(&p->pt, ev, data);
+         ret = p->desc->thread(&p->pt, ev, data);
          clock_end = clock_time();
          lc_end = p->pt.lc;
 
          if (clock_end - clock_start > MS_TO_CLOCK_SECOND( 14 )) {
              CONTIKI_PRINTF( "--> process: '%s' took too long (%ld:0x%p-%ld:0x%p = %ld ticks)\n",
-                             p->name, clock_start, lc_start, clock_end, lc_end, clock_end-clock_start );
+                             PROCESS_NAME_STRING(p), clock_start, lc_start, clock_end, lc_end, clock_end-clock_start );
          }
       }
 #else
@@ -247,17 +613,38 @@ static void call_process(struct process *p, process_event_t ev, process_data_t d
 
          clock_start = clock_time();
          lc_start = p->pt.lc;
-         ret = p->thread(&p->pt, ev, data);
+         ret = p->desc->thread(&p->pt, ev, data);
          clock_end = clock_time();
          lc_end = p->pt.lc;
 
          if (clock_end - clock_start > MS_TO_CLOCK_SECOND( 14 )) {
              CONTIKI_PRINTF( "--> process: '%s' took too long (%ld:%d-%ld:%d = %ld ticks)\n",
-                             p->name, clock_start, lc_start, clock_end, lc_end, clock_end-clock_start );
+                             PROCESS_NAME_STRING(p), clock_start, lc_start, clock_end, lc_end, clock_end-clock_start );
          }
       }
 #endif
 
+#if PROCESS_CONF_BUDGET
+      {
+         uint32_t used = clock_usecs() - budget_start;
+
+         p->budget.total_us += used;
+         if (used > p->budget.max_us) {
+            p->budget.max_us = used;
+         }
+         if (used > PROCESS_CTX->budget) {
+            ++p->budget.overruns;
+         }
+         budget_start = caller_start;
+      }
+#endif
+#if PROCESS_CONF_STATS
+      if (ev == PROCESS_EVENT_INIT) {
+         ++PROCESS_CTX->inits;
+         PROCESS_CTX->init_us += clock_usecs() - init_start;
+      }
+#endif
+
       if (ret == PT_EXITED ||
           ret == PT_ENDED  ||
           ev == PROCESS_EVENT_EXIT) {
@@ -269,6 +656,19 @@ static void call_process(struct process *p, process_event_t ev, process_data_t d
    }
 }
 /*---------------------------------------------------------------------------*/
+void process_add_exit_hook(struct process_exit_hook *hook)
+{
+   struct process_exit_hook *h;
+
+   for (h = exit_hooks;  h != NULL;  h = h->next) {
+      if (h == hook) {
+         return;
+      }
+   }
+   hook->next = exit_hooks;
+   exit_hooks = hook;
+}
+/*---------------------------------------------------------------------------*/
 void process_exit(struct process *p)
 {
    assert( !CONTIKI_IN_ISR()  &&  initialized );
@@ -276,25 +676,215 @@ void process_exit(struct process *p)
    exit_process(p, PROCESS_CURRENT());
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_NOW_SNAPSHOT
+#define NOW_NONE      0     /* outside of process_run() */
+#define NOW_PENDING   1     /* in process_run(), clock not read yet */
+#define NOW_TAKEN     2
+#endif
+
 void process_init(void)
 {
    lastevent = PROCESS_EVENT_MAX;
 
    nevents = fevent = 0;
+#if PROCESS_PAUSE_QUEUE
+   pause_head = pause_tail = NULL;
+   npaused = 0;
+#endif
+#if PROCESS_PAUSE_QUEUE  ||  ETIMER_CONF_DIRECT_DELIVERY
+   deliver_seq = 0;
+#endif
+#if ETIMER_CONF_DIRECT_DELIVERY
+   expired_head = expired_tail = NULL;
+   nexpired = 0;
+#endif
+#if PROCESS_CONF_MAILBOXES
+   ready_head = ready_tail = NULL;
+   nmail = 0;
+   broadcast_turn = 0;
+#endif
 #if PROCESS_CONF_STATS
-   process_maxevents = 0;
+   process_stats_reset();
 #endif /* PROCESS_CONF_STATS */
+#if PROCESS_CONF_NOW_SNAPSHOT
+   PROCESS_CTX->now_state = NOW_NONE;
+#endif
+#if PROCESS_CONF_BUDGET
+   PROCESS_CTX->budget = PROCESS_CONF_BUDGET_US;
+#endif
+#if PROCESS_CONF_FAIRNESS
+   PROCESS_CTX->fair_rounds = 0;
+#endif
 
    process_current = process_list = NULL;
+#if PROCESS_CONF_COMPACT_EVENTS
+   memset(process_table, 0, sizeof(process_table));
+#endif
 
    initialized = 1;
    poll_requested = 0;
+
+   tasklet_init();
+
+#if PROCESS_CONF_CONTEXTS
+   etimer_context_init();
+   ctimer_context_init();
+#endif
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_CONTEXTS
+void process_context_init(struct process_context *ctx,
+                          struct process_event_slot *evbuf, uint16_t numevents)
+{
+   assert( numevents != 0  &&  (numevents & (numevents - 1)) == 0 );
+
+   memset(ctx, 0, sizeof(*ctx));
+   ctx->event_buf  = evbuf;
+   ctx->event_mask = numevents - 1;
 }
 /*---------------------------------------------------------------------------*/
+struct process_context *process_context_select(struct process_context *ctx)
+{
+   struct process_context *prev = process_ctx;
+
+   prev->list    = process_list;
+   prev->current = process_current;
+   process_ctx = (ctx != NULL) ? ctx : &process_default_ctx;
+   process_list    = process_ctx->list;
+   process_current = process_ctx->current;
+   return prev;
+}
+#endif
+/*---------------------------------------------------------------------------*/
 /*
  * Call each process' poll handler.
  */
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_FAIRNESS
+/*
+ * Check the budget of \a p.  If it is used up, mark the process as
+ * deferred.
+ */
+static bool fair_may_dispatch(struct process *p)
+{
+   if (p->fair.credits != 0  ||  p->state == PROCESS_STATE_NONE) {
+      return true;
+   }
+   if ( !p->fair.deferred) {
+      p->fair.deferred = 1;
+      p->fair.deferred_since = clock_time();
+      ++p->fair.deferrals;
+   }
+   fair_blocked = true;
+   return false;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Account a dispatch of \a p, \a budget tells if it is charged to its credits.
+ */
+static void fair_account(struct process *p, bool budget)
+{
+   if (budget  &&  p->fair.credits != 0) {
+      --p->fair.credits;
+   }
+   ++p->fair.dispatches;
+   if (p->fair.deferred) {
+      clock_time_t starvation = clock_time() - p->fair.deferred_since;
+
+      if (starvation > p->fair.max_starvation) {
+         p->fair.max_starvation = starvation;
+      }
+      p->fair.deferred = 0;
+   }
+   fair_dispatched = true;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Refill the budgets of all processes and rotate the process list, so
+ * that another process comes first.
+ */
+static void fair_new_round(void)
+{
+   struct process *p;
+   struct process *last = NULL;
+
+   for (p = process_list; p != NULL; p = p->next) {
+      p->fair.credits = FAIR_WEIGHT(p);
+      last = p;
+   }
+
+   if (last != process_list) {
+      p = process_list;
+      process_list = p->next;
+      p->next = NULL;
+      last->next = p;
+   }
+   ++PROCESS_CTX->fair_rounds;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Select the first event in the queue which may be delivered.  This is the
+ * first event whose receiver has credits left, so the order of events per
+ * receiver is kept.  Broadcast events are a barrier, they are only
+ * delivered from the head of the queue.
+ *
+ * \return  offset of the event relative to fevent, nevents if there is none
+ */
+static process_num_events_t fair_select_event(void)
+{
+   process_num_events_t k;
+   process_num_events_t i = fevent;
+
+   for (k = 0;  k < nevents;  ++k) {
+      struct process *receiver = slot_process(&events[i]);
+
+      if (receiver == PROCESS_BROADCAST) {
+         if (k == 0) {
+            return 0;
+         }
+         break;
+      }
+      if (receiver == PROCESS_ZOMBIE  ||  fair_may_dispatch(receiver)) {
+         return k;
+      }
+      i = (i + 1) & EVENTS_MASK;
+   }
+   return nevents;
+}
+/*---------------------------------------------------------------------------*/
+void process_set_weight(struct process *p, uint8_t weight)
+{
+   p->fair.weight = weight;
+   if (p->fair.credits > FAIR_WEIGHT(p)) {
+      p->fair.credits = FAIR_WEIGHT(p);
+   }
+}
+/*---------------------------------------------------------------------------*/
+uint32_t process_fair_rounds(void)
+{
+   return PROCESS_CTX->fair_rounds;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_BUDGET
+void process_set_budget(uint32_t us)
+{
+   PROCESS_CTX->budget = us;
+}
+/*---------------------------------------------------------------------------*/
+void process_budget_report(void)
+{
+   struct process *p;
+
+   for (p = process_list; p != NULL; p = p->next) {
+      CONTIKI_PRINTF( "process '%s': %lu us total, %lu us max, %u yields, %u overruns\n",
+                      PROCESS_NAME_STRING(p),
+                      (unsigned long)p->budget.total_us, (unsigned long)p->budget.max_us,
+                      p->budget.yields, p->budget.overruns );
+   }
+}
+#endif
+/*---------------------------------------------------------------------------*/
 static void do_poll(void)
 {
    struct process *p;
@@ -303,6 +893,14 @@ static void do_poll(void)
    /* Call the processes that needs to be polled. */
    for (p = process_list; p != NULL; p = p->next) {
       if (p->needspoll) {
+#if PROCESS_CONF_FAIRNESS
+         if ( !fair_may_dispatch(p)) {
+            /* keep the poll request for the next round */
+            poll_requested = 1;
+            continue;
+         }
+         fair_account(p, true);
+#endif
          p->state = PROCESS_STATE_RUNNING;
          p->needspoll = 0;
          call_process(p, PROCESS_EVENT_POLL, NULL);
@@ -310,6 +908,143 @@ static void do_poll(void)
    }
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_MAILBOXES
+/*
+ * Append \a p to the ready list if it is not already in there.
+ */
+static void ready_append(struct process *p)
+{
+   if ( !p->mbox.ready) {
+      p->mbox.ready = 1;
+      p->mbox.ready_next = NULL;
+      if (ready_head == NULL) {
+         ready_head = p;
+      }
+      else {
+         ready_tail->mbox.ready_next = p;
+      }
+      ready_tail = p;
+   }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Deliver the oldest event of the first ready process.  The process is
+ * appended again to the ready list if it has more mail, so processes with
+ * mail are served round robin.
+ */
+static void do_mail(void)
+{
+   struct process *p;
+   struct process *prev = NULL;
+   struct process_mail *m;
+   process_event_t ev;
+   process_data_t data;
+
+   for (p = ready_head;  p != NULL;  prev = p, p = p->mbox.ready_next) {
+#if PROCESS_CONF_FAIRNESS
+      if (p->mbox.n == 0  ||  fair_may_dispatch(p)) {
+         break;
+      }
+#else
+      break;
+#endif
+   }
+   if (p == NULL) {
+      /* all receivers are out of budget */
+      return;
+   }
+
+   /* unlink p */
+   if (prev == NULL) {
+      ready_head = p->mbox.ready_next;
+   }
+   else {
+      prev->mbox.ready_next = p->mbox.ready_next;
+   }
+   if (ready_tail == p) {
+      ready_tail = prev;
+   }
+   p->mbox.ready = 0;
+
+   if (p->mbox.n == 0) {
+      /* process has exited meanwhile */
+      return;
+   }
+
+   m = &p->mbox.slots[p->mbox.first];
+   ev = m->ev;
+   data = m->data;
+   p->mbox.first = (p->mbox.first + 1) & p->mbox.mask;
+   --p->mbox.n;
+   --nmail;
+   if (p->mbox.n != 0) {
+      ready_append(p);
+   }
+
+   if (ev == PROCESS_EVENT_INIT) {
+      p->state = PROCESS_STATE_RUNNING;
+   }
+#if PROCESS_CONF_FAIRNESS
+   fair_account(p, true);
+#endif
+   call_process(p, ev, data);
+}
+#endif
+/*---------------------------------------------------------------------------*/
+#if PROCESS_PAUSE_QUEUE
+/*
+ * Deliver PROCESS_EVENT_CONTINUE to the first paused process, if all
+ * events which have been posted before its pause are delivered.
+ * \return true if the paused process has been dispatched.
+ */
+static bool do_pause(void)
+{
+   struct process *p = pause_head;
+
+   if (p == NULL  ||  (nevents != 0  &&  (int16_t)(deliver_seq - p->pause_seq) < 0)) {
+      return false;
+   }
+
+   pause_head = p->pause_next;
+   if (pause_head == NULL) {
+      pause_tail = NULL;
+   }
+   p->paused = 0;
+   --npaused;
+
+   call_process(p, PROCESS_EVENT_CONTINUE, NULL);
+   return true;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+#if ETIMER_CONF_DIRECT_DELIVERY
+/*
+ * Deliver PROCESS_EVENT_TIMER for the first expired etimer, if all
+ * events which have been posted before its expiry are delivered.
+ * \return true if the timer has been dispatched.
+ */
+static bool do_timer(void)
+{
+   struct etimer *et = expired_head;
+   struct process *p;
+
+   if (et == NULL  ||  (nevents != 0  &&  (int16_t)(deliver_seq - et->expired_seq) < 0)) {
+      return false;
+   }
+   p = et->expired_p;
+
+   expired_head = et->expired_next;
+   if (expired_head == NULL) {
+      expired_tail = NULL;
+   }
+   et->expired_p = NULL;
+   --nexpired;
+
+   call_process(p, PROCESS_EVENT_TIMER, et);
+   return true;
+}
+#endif
+/*---------------------------------------------------------------------------*/
 /*
  * Process the next event in the event queue and deliver it to
  * listening processes.
@@ -317,6 +1052,26 @@ static void do_poll(void)
 /*---------------------------------------------------------------------------*/
 static void do_event(void)
 {
+#if PROCESS_CONF_MAILBOXES
+   /* Alternate between mailboxes and broadcast queue */
+   if (ready_head != NULL  &&  ((nevents + nexpired) == 0  ||  !broadcast_turn)) {
+      broadcast_turn = 1;
+      do_mail();
+      return;
+   }
+   broadcast_turn = 0;
+#endif
+#if PROCESS_PAUSE_QUEUE
+   if (do_pause()) {
+      return;
+   }
+#endif
+#if ETIMER_CONF_DIRECT_DELIVERY
+   if (do_timer()) {
+      return;
+   }
+#endif
+
    /*
     * If there are any events in the queue, take the first one and walk
     * through the list of processes to see if the event should be
@@ -330,16 +1085,41 @@ static void do_event(void)
       register process_data_t  data;
       register struct process *receiver;
 
+#if PROCESS_CONF_FAIRNESS
+      process_num_events_t k = fair_select_event();
+      process_num_events_t i;
+
+      if (k == nevents) {
+         /* all receivers are out of budget */
+         return;
+      }
+
+      i = (fevent + k) & EVENTS_MASK;
+      ev = events[i].ev;
+      data = slot_data(&events[i]);
+      receiver = slot_process(&events[i]);
+
+      /* Close the gap by moving the skipped events up by one slot. */
+      while (i != fevent) {
+         process_num_events_t prev = (i - 1) & EVENTS_MASK;
+         events[i] = events[prev];
+         i = prev;
+      }
+#else
       /* There are events that we should deliver. */
       ev = events[fevent].ev;
 
-      data = events[fevent].data;
-      receiver = events[fevent].p;
+      data = slot_data(&events[fevent]);
+      receiver = slot_process(&events[fevent]);
+#endif
 
       /* Since we have seen the new event, we move pointer upwards
          and decrese the number of events. */
-      fevent = (fevent + 1) & (PROCESS_CONF_NUMEVENTS - 1);
+      fevent = (fevent + 1) & EVENTS_MASK;
       --nevents;
+#if PROCESS_PAUSE_QUEUE  ||  ETIMER_CONF_DIRECT_DELIVERY
+      ++deliver_seq;
+#endif
 
       /* If this is a broadcast event, we deliver it to all events, in
          order of their priority. */
@@ -353,6 +1133,9 @@ static void do_event(void)
             if (poll_requested) {
                do_poll();
             }
+#if PROCESS_CONF_FAIRNESS
+            fair_account(p, false);
+#endif
             call_process(p, ev, data);
          }
       }
@@ -367,6 +1150,9 @@ static void do_event(void)
          if (ev == PROCESS_EVENT_INIT) {
             receiver->state = PROCESS_STATE_RUNNING;
          }
+#if PROCESS_CONF_FAIRNESS
+         fair_account(receiver, true);
+#endif
 
          /* Make sure that the process actually is running. */
          call_process(receiver, ev, data);
@@ -374,25 +1160,93 @@ static void do_event(void)
    }
 }
 /*---------------------------------------------------------------------------*/
+clock_time_t process_now(void)
+{
+#if PROCESS_CONF_NOW_SNAPSHOT
+   if (PROCESS_CTX->now_state == NOW_TAKEN) {
+#if PROCESS_CONF_STATS
+      ++PROCESS_CTX->clock_reads_saved;
+#endif
+      return PROCESS_CTX->now;
+   }
+#if PROCESS_CONF_STATS
+   ++PROCESS_CTX->clock_reads;
+#endif
+   PROCESS_CTX->now = clock_time();
+   if (PROCESS_CTX->now_state == NOW_PENDING) {
+      PROCESS_CTX->now_state = NOW_TAKEN;
+   }
+   return PROCESS_CTX->now;
+#else
+#if PROCESS_CONF_STATS
+   ++PROCESS_CTX->clock_reads;
+#endif
+   return clock_time();
+#endif
+}
+/*---------------------------------------------------------------------------*/
 uint16_t process_run(void)
 {
     assert( !CONTIKI_IN_ISR() );
     assert( initialized );
 
+#if PROCESS_CONF_NOW_SNAPSHOT
+   PROCESS_CTX->now_state = NOW_PENDING;
+#endif
+
+#if PROCESS_CONF_FAIRNESS
+   fair_blocked = fair_dispatched = false;
+#endif
+
+#if ETIMER_CONF_DEFERRED_UPDATE
+   /* timers set outside of process_run() */
+   if (PROCESS_CTX->etimers.stale) {
+      etimer_sync();
+   }
+#endif
+
+#if ETIMER_CONF_SCHEDULER_EXPIRY
+   /* Deliver expired etimers without a hop through etimer_process */
+   if (PROCESS_CTX->etimers.armed  &&  CLOCK_A_GE_B(process_now() - CLOCK_STEP, PROCESS_CTX->next_expiration)) {
+      etimer_run();
+   }
+#endif
+
    /* Process poll events. */
    if (poll_requested) {
       do_poll();
    }
 
+   /* Execute deferred function calls */
+   tasklet_run();
+
    /* Process one event from the queue */
    do_event();
 
-   return nevents + poll_requested;
+#if PROCESS_CONF_FAIRNESS
+   /* Pending work which cannot be dispatched anymore starts a new round */
+   if (fair_blocked  &&  !fair_dispatched) {
+      fair_new_round();
+   }
+#endif
+
+#if ETIMER_CONF_DEFERRED_UPDATE
+   /* Program the clock alarm once for all timer changes of this round */
+   if (PROCESS_CTX->etimers.stale) {
+      etimer_sync();
+   }
+#endif
+
+#if PROCESS_CONF_NOW_SNAPSHOT
+   PROCESS_CTX->now_state = NOW_NONE;
+#endif
+
+   return nevents + nmail + npaused + nexpired + poll_requested + tasklet_pending();
 }
 /*---------------------------------------------------------------------------*/
 uint16_t process_nevents(void)
 {
-   return nevents + poll_requested;
+   return nevents + nmail + npaused + nexpired + poll_requested + tasklet_pending();
 }
 /*---------------------------------------------------------------------------*/
 uint16_t process_nevents_p(struct process *p)
@@ -400,40 +1254,195 @@ uint16_t process_nevents_p(struct process *p)
    process_num_events_t r = 0;
 
    if (p == NULL) {
-      r = nevents;
+      r = nevents + nmail + npaused + nexpired;
    }
    else {
+#if ETIMER_CONF_DIRECT_DELIVERY
+      struct etimer *et;
+
+      for (et = expired_head;  et != NULL;  et = et->expired_next) {
+         r += (et->expired_p == p);
+      }
+#endif
+#if PROCESS_CONF_MAILBOXES
+      r += p->mbox.n;
+#else
       process_num_events_t n;
       process_num_events_t i = fevent;
       for (n = nevents; n > 0; n--) {
-         if (events[i].p == p) {
+         if (slot_process(&events[i]) == p) {
             ++r;
          }
-         i = (i + 1) & (PROCESS_CONF_NUMEVENTS - 1);
+         i = (i + 1) & EVENTS_MASK;
       }
+#if PROCESS_PAUSE_QUEUE
+      r += p->paused;
+#endif
+#endif
    }
    return r;
 }
 /*---------------------------------------------------------------------------*/
+int16_t process_event_peek(uint16_t i, struct process_queued_event *e)
+{
+   const struct process_event_slot *s;
+
+   if (i >= nevents) {
+      return 0;
+   }
+   s = &events[(fevent + i) & EVENTS_MASK];
+   e->ev   = s->ev;
+   e->data = slot_data(s);
+   e->p    = slot_process(s);
+   return 1;
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_MAILBOXES
+uint16_t process_mailbox_space(struct process *p)
+{
+   return p->mbox.mask + 1 - p->mbox.n;
+}
+#endif
+/*---------------------------------------------------------------------------*/
 void process_post(struct process *p, process_event_t ev, process_data_t data)
 {
    register uint16_t snum;
 
    assert( !CONTIKI_IN_ISR() );
    assert( initialized );
-   assert( nevents != PROCESS_CONF_NUMEVENTS );
 
-   snum = (fevent + nevents) & (PROCESS_CONF_NUMEVENTS - 1);
-   events[snum].ev = ev;
-   events[snum].data = data;
-   events[snum].p = p;
-   ++nevents;
+#if PROCESS_CONF_MAILBOXES
+   if (p != PROCESS_BROADCAST) {
+      struct process_mailbox *mb = &p->mbox;
+
+      assert( mb->n <= mb->mask );
+      snum = (mb->first + mb->n) & mb->mask;
+      mb->slots[snum].ev = ev;
+      mb->slots[snum].data = data;
+      ++mb->n;
+      ++nmail;
+      ready_append(p);
+   }
+   else
+#endif
+   {
+      assert( nevents != EVENTS_MASK + 1 );
+
+      snum = (fevent + nevents) & EVENTS_MASK;
+      slot_set(&events[snum], ev, data, p);
+      ++nevents;
+   }
+
+#if PROCESS_CONF_STATS
+   if (nevents + nmail > PROCESS_CTX->maxevents) {
+      PROCESS_CTX->maxevents = nevents + nmail;
+   }
+#endif /* PROCESS_CONF_STATS */
+}
+/*---------------------------------------------------------------------------*/
+#if ETIMER_CONF_DIRECT_DELIVERY
+int16_t process_timer_pending(struct etimer *et)
+{
+   struct etimer *q;
+
+   if (et->expired_p == NULL) {
+      return 0;
+   }
+   /* the list of undelivered timers is short */
+   for (q = expired_head;  q != NULL;  q = q->expired_next) {
+      if (q == et) {
+         return 1;
+      }
+   }
+   /* stale receiver of an uninitialized timer */
+   et->expired_p = NULL;
+   return 0;
+}
+/*---------------------------------------------------------------------------*/
+int16_t process_post_timer(struct process *p, struct etimer *et)
+{
+   assert( !CONTIKI_IN_ISR() );
+   assert( initialized );
+
+   if (p == PROCESS_BROADCAST) {
+      process_post(p, PROCESS_EVENT_TIMER, et);
+      return 1;
+   }
+   if (process_timer_pending(et)) {
+      /* delivered once for both expiries */
+      et->expired_p = p;
+      return 0;
+   }
+
+   et->expired_p    = p;
+   et->expired_seq  = deliver_seq + nevents;
+   et->expired_next = NULL;
+   if (expired_tail == NULL) {
+      expired_head = et;
+   }
+   else {
+      expired_tail->expired_next = et;
+   }
+   expired_tail = et;
+   ++nexpired;
 
 #if PROCESS_CONF_STATS
-   if (nevents > process_maxevents) {
-      process_maxevents = nevents;
+   if (nexpired > PROCESS_CTX->maxexpired) {
+      PROCESS_CTX->maxexpired = nexpired;
    }
 #endif /* PROCESS_CONF_STATS */
+   return 1;
+}
+/*---------------------------------------------------------------------------*/
+void process_cancel_timer(struct etimer *et)
+{
+   struct etimer *prev = NULL;
+   struct etimer *q;
+
+   if ( !process_timer_pending(et)) {
+      return;
+   }
+   for (q = expired_head;  q != et;  q = q->expired_next) {
+      prev = q;
+   }
+   if (prev == NULL) {
+      expired_head = et->expired_next;
+   }
+   else {
+      prev->expired_next = et->expired_next;
+   }
+   if (expired_tail == et) {
+      expired_tail = prev;
+   }
+   et->expired_p = NULL;
+   --nexpired;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+void process_pause(void)
+{
+#if PROCESS_PAUSE_QUEUE
+   struct process *p = process_current;
+
+   assert( !CONTIKI_IN_ISR() );
+   assert( initialized  &&  p != NULL );
+
+   if ( !p->paused) {
+      p->paused = 1;
+      p->pause_seq = deliver_seq + nevents;
+      p->pause_next = NULL;
+      if (pause_tail == NULL) {
+         pause_head = p;
+      }
+      else {
+         pause_tail->pause_next = p;
+      }
+      pause_tail = p;
+      ++npaused;
+   }
+#else
+   process_post(process_current, PROCESS_EVENT_CONTINUE, NULL);
+#endif
 }
 /*---------------------------------------------------------------------------*/
 void process_post_synch(struct process *p, process_event_t ev, process_data_t data)
@@ -472,10 +1481,55 @@ int16_t process_is_running(struct process *p)
         }
     }
     if (p->state != PROCESS_STATE_NONE) {
-        CONTIKI_PRINTF( "process_is_running: '%s' inconsistent %d\n", p->name, p->state );
+        CONTIKI_PRINTF( "process_is_running: '%s' inconsistent %d\n", PROCESS_NAME_STRING(p), p->state );
     }
 #endif
     return p->state != PROCESS_STATE_NONE;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_STATS
+uint16_t process_maxevents(void)
+{
+   return PROCESS_CTX->maxevents;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t process_inits(void)
+{
+   return PROCESS_CTX->inits;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t process_init_us(void)
+{
+   return PROCESS_CTX->init_us;
+}
+/*---------------------------------------------------------------------------*/
+#if ETIMER_CONF_DIRECT_DELIVERY
+uint16_t process_maxexpired(void)
+{
+   return PROCESS_CTX->maxexpired;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+uint32_t process_clock_reads(void)
+{
+   return PROCESS_CTX->clock_reads;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t process_clock_reads_saved(void)
+{
+   return PROCESS_CTX->clock_reads_saved;
+}
+/*---------------------------------------------------------------------------*/
+void process_stats_reset(void)
+{
+   PROCESS_CTX->maxevents = 0;
+   PROCESS_CTX->inits = 0;
+   PROCESS_CTX->init_us = 0;
+#if ETIMER_CONF_DIRECT_DELIVERY
+   PROCESS_CTX->maxexpired = 0;
+#endif
+   PROCESS_CTX->clock_reads = PROCESS_CTX->clock_reads_saved = 0;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* PROCESS_CONF_STATS */
 /** @} */
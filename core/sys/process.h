@@ -55,6 +55,11 @@
 #include <stdint.h>
 #include "sys/pt.h"
 #include "sys/cc.h"
+#include "sys/tasklet.h"
+#include "sys/etimer-queue.h"
+#if PROCESS_CONF_BUDGET
+   #include "sys/clock.h"
+#endif
 
 #ifdef __cplusplus
     extern "C"
@@ -70,6 +75,141 @@ typedef void *        process_data_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+#ifndef PROCESS_CONF_FAIRNESS
+/**
+ * Enable weighted fair dispatching, see process_set_weight().
+ */
+#define PROCESS_CONF_FAIRNESS 0
+#endif /* PROCESS_CONF_FAIRNESS */
+
+#ifndef PROCESS_CONF_CONTEXTS
+/**
+ * Enable multiple scheduler contexts, see process_context_select().
+ * If disabled, the single default context is addressed statically.
+ */
+#define PROCESS_CONF_CONTEXTS 0
+#endif /* PROCESS_CONF_CONTEXTS */
+
+#ifndef PROCESS_CONF_CONTEXT_STORAGE
+/**
+ * Storage class of the pointer to the selected context, process_list and
+ * process_current, e.g. \c _Thread_local to run independent schedulers in
+ * parallel threads.
+ */
+#define PROCESS_CONF_CONTEXT_STORAGE
+#endif /* PROCESS_CONF_CONTEXT_STORAGE */
+
+#ifndef PROCESS_CONF_MAILBOXES
+/**
+ * Enable per process mailboxes instead of the single event queue for
+ * events posted to a specific process, see PROCESS_WITH_MAILBOX().
+ */
+#define PROCESS_CONF_MAILBOXES 0
+#endif /* PROCESS_CONF_MAILBOXES */
+
+#ifndef PROCESS_CONF_MAILBOX_SIZE
+/**
+ * Mailbox size of processes declared with PROCESS(), must be a power of 2.
+ */
+#define PROCESS_CONF_MAILBOX_SIZE 4
+#endif /* PROCESS_CONF_MAILBOX_SIZE */
+
+#ifndef PROCESS_CONF_SERVICE_MAILBOX_SIZE
+/**
+ * Mailbox size of the system processes (etimer_process, ctimer_process),
+ * must be a power of 2.
+ */
+#define PROCESS_CONF_SERVICE_MAILBOX_SIZE 16
+#endif /* PROCESS_CONF_SERVICE_MAILBOX_SIZE */
+
+#ifndef PROCESS_CONF_PAUSE_QUEUE
+/**
+ * Let PROCESS_PAUSE() mark the process runnable instead of posting
+ * PROCESS_EVENT_CONTINUE through the event queue, see process_pause().
+ * Not used with PROCESS_CONF_MAILBOXES, where the self posted event
+ * occupies the own mailbox only, and not with PROCESS_CONF_FAIRNESS,
+ * which delivers the events out of order, so the position of the pause
+ * in the queue cannot be told by a count of delivered events.
+ */
+#define PROCESS_CONF_PAUSE_QUEUE 1
+#endif /* PROCESS_CONF_PAUSE_QUEUE */
+
+/** Pausing uses the queue of runnable processes */
+#define PROCESS_PAUSE_QUEUE  (PROCESS_CONF_PAUSE_QUEUE  &&  !PROCESS_CONF_MAILBOXES  &&  !PROCESS_CONF_FAIRNESS)
+
+#ifndef PROCESS_CONF_EXITED_EVENT
+/**
+ * Call all other processes synchronously with PROCESS_EVENT_EXITED when a
+ * process exits, as in the original Contiki.  Services use exit hooks
+ * instead, see process_add_exit_hook().
+ */
+#define PROCESS_CONF_EXITED_EVENT 0
+#endif /* PROCESS_CONF_EXITED_EVENT */
+
+#ifndef PROCESS_CONF_CHILDREN
+/**
+ * Enable child protothreads which are resumed directly by the
+ * scheduler, see PROCESS_SPAWN_CHILD().
+ */
+#define PROCESS_CONF_CHILDREN 0
+#endif /* PROCESS_CONF_CHILDREN */
+
+#ifndef PROCESS_CONF_COMPACT_EVENTS
+/**
+ * Store the receiver of a queued event as 8 bit index into a table of
+ * the started processes and the data without padding: a slot takes 6
+ * instead of 12 bytes on 32 bit targets, see struct process_event_slot.
+ */
+#define PROCESS_CONF_COMPACT_EVENTS 0
+#endif /* PROCESS_CONF_COMPACT_EVENTS */
+
+#ifndef PROCESS_CONF_MAX_PROCESSES
+/**
+ * Size of the process table with PROCESS_CONF_COMPACT_EVENTS, i.e. the
+ * maximum number of processes running at the same time, max 254.
+ */
+#define PROCESS_CONF_MAX_PROCESSES 16
+#endif /* PROCESS_CONF_MAX_PROCESSES */
+
+#ifndef PROCESS_CONF_NO_PROCESS_NAMES
+/**
+ * Compile out the string names of the processes, PROCESS_NAME_STRING()
+ * is then "".
+ */
+#define PROCESS_CONF_NO_PROCESS_NAMES 0
+#endif /* PROCESS_CONF_NO_PROCESS_NAMES */
+
+#ifndef PROCESS_CONF_LAZY_START
+/**
+ * Enable process_start_lazy(), which defers PROCESS_EVENT_INIT until the
+ * first event or poll of the process.
+ */
+#define PROCESS_CONF_LAZY_START 0
+#endif /* PROCESS_CONF_LAZY_START */
+
+#ifndef PROCESS_CONF_BUDGET
+/**
+ * Enable the dispatch time budget, see PROCESS_YIELD_IF_OVER_BUDGET().
+ * Requires clock_usecs() from the port.
+ */
+#define PROCESS_CONF_BUDGET 0
+#endif /* PROCESS_CONF_BUDGET */
+
+#ifndef PROCESS_CONF_BUDGET_US
+/**
+ * Default time budget of one dispatch in microseconds, see process_set_budget().
+ */
+#define PROCESS_CONF_BUDGET_US 1000
+#endif /* PROCESS_CONF_BUDGET_US */
+
+#ifndef PROCESS_CONF_NOW_SNAPSHOT
+/**
+ * Read the clock at most once per process_run() round, see process_now().
+ * The etimer expiry checks of a round then are plain comparisons.
+ */
+#define PROCESS_CONF_NOW_SNAPSHOT 1
+#endif /* PROCESS_CONF_NOW_SNAPSHOT */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -203,6 +343,51 @@ typedef void *        process_data_t;
  */
 #define PROCESS_PT_SPAWN(pt, thread)   PT_SPAWN(process_pt, pt, thread)
 
+#if PROCESS_CONF_CHILDREN
+/**
+ * Spawn a child protothread and wait until it exits.
+ *
+ * In contrast to PROCESS_PT_SPAWN() the scheduler keeps track of the
+ * innermost running child of a process and delivers events directly to
+ * it.  The parents are not re-entered on every event, so the resume cost
+ * does not grow with the nesting depth.  When a child ends, its parent
+ * is resumed with the same event, exactly as with PROCESS_PT_SPAWN().
+ *
+ * Children may spawn children themselves.  PROCESS_EXIT() in a child
+ * ends the child only.
+ *
+ * \param child  The struct process_child of the new child.
+ * \param thread The child function, defined with PROCESS_CHILD_THREAD().
+ * \param arg    Argument of the child, see PROCESS_CHILD_ARG().
+ *
+ * \hideinitializer
+ */
+#define PROCESS_SPAWN_CHILD(child, thread, arg)  do {             \
+  process_child_start((child), (thread), (arg));                  \
+  PT_WAIT_WHILE(process_pt, (child)->running);                    \
+} while(0)
+
+/**
+ * Define the body of a child protothread for PROCESS_SPAWN_CHILD().
+ *
+ * The body is written like a PROCESS_THREAD(), i.e. with
+ * PROCESS_BEGIN(), PROCESS_END() and the PROCESS_WAIT_xxx() macros.
+ *
+ * \hideinitializer
+ */
+#define PROCESS_CHILD_THREAD(name, ev, data)                      \
+static PT_THREAD(name(struct pt *process_pt,                      \
+                      process_event_t ev,                         \
+                      process_data_t data))
+
+/**
+ * Argument given to PROCESS_SPAWN_CHILD(), only valid inside a PROCESS_CHILD_THREAD().
+ *
+ * \hideinitializer
+ */
+#define PROCESS_CHILD_ARG()  (((struct process_child *)process_pt)->arg)
+#endif
+
 /**
  * Yield the process for a short while.
  *
@@ -212,7 +397,7 @@ typedef void *        process_data_t;
  * \hideinitializer
  */
 #define PROCESS_PAUSE()             do {                          \
-  process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL);  \
+  process_pause();                                                \
   PROCESS_WAIT_EVENT();                                           \
 } while(0)
 
@@ -225,10 +410,50 @@ typedef void *        process_data_t;
  * \hideinitializer
  */
 #define PROCESS_PAUSE_STRICT()             do {                   \
-  process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL);  \
+  process_pause();                                                \
   PROCESS_YIELD_UNTIL( ev == PROCESS_EVENT_CONTINUE );             \
 } while(0)
 
+/**
+ * Check if the current dispatch has used up its time budget.
+ *
+ * The scheduler takes a time stamp before each dispatch, so the check is
+ * one clock_usecs() call and a compare.  Always false without
+ * PROCESS_CONF_BUDGET.
+ *
+ * \hideinitializer
+ */
+#if PROCESS_CONF_BUDGET
+#define PROCESS_OVER_BUDGET()                                              \
+  ((uint32_t)(clock_usecs() - PROCESS_CTX->budget_start) >= PROCESS_CTX->budget)
+#else
+#define PROCESS_OVER_BUDGET()       0
+#endif
+
+/**
+ * Yield the process if the current dispatch has used up its time budget.
+ *
+ * Meant for long running loops, e.g. filtering a buffer: call it once per
+ * iteration instead of PROCESS_PAUSE() at hand picked points.  The process
+ * is paused like with PROCESS_PAUSE() only if the budget (see
+ * process_set_budget()) is exceeded, otherwise it continues immediately.
+ * Local variables are lost on yield as with every other wait.
+ *
+ * Without PROCESS_CONF_BUDGET this is a no-op.
+ *
+ * \hideinitializer
+ */
+#if PROCESS_CONF_BUDGET
+#define PROCESS_YIELD_IF_OVER_BUDGET()  do {                      \
+  if (PROCESS_OVER_BUDGET()) {                                    \
+    ++PROCESS_CURRENT()->budget.yields;                           \
+    PROCESS_PAUSE();                                              \
+  }                                                               \
+} while(0)
+#else
+#define PROCESS_YIELD_IF_OVER_BUDGET()
+#endif
+
 /** @} end of protothread functions */
 
 /**
@@ -293,6 +518,35 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
  */
 #define PROCESS_NAME(name) extern struct process name
 
+/**
+ * The human readable name of process \a p.
+ *
+ * \hideinitializer
+ */
+#if PROCESS_CONF_NO_PROCESS_NAMES
+#define PROCESS_NAME_STRING(p) ""
+#else
+#define PROCESS_NAME_STRING(p) ((p)->desc->name)
+#endif
+
+/**
+ * Define the constant descriptor of a process.
+ *
+ * Used by PROCESS() and for processes whose struct process is set up
+ * at run time.  The descriptor is const, so it is kept in flash.
+ *
+ * \hideinitializer
+ */
+#if PROCESS_CONF_NO_PROCESS_NAMES
+#define PROCESS_DESC(name, strname)                                   \
+  static const struct process_desc process_desc_##name =              \
+    { &process_thread_##name }
+#else
+#define PROCESS_DESC(name, strname)                                   \
+  static const struct process_desc process_desc_##name =              \
+    { strname, &process_thread_##name }
+#endif
+
 /**
  * Declare a process.
  *
@@ -305,25 +559,345 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
  *
  * \hideinitializer
  */
+#if PROCESS_CONF_MAILBOXES
+#define PROCESS(name, strname)                   \
+  PROCESS_WITH_MAILBOX(name, strname, PROCESS_CONF_MAILBOX_SIZE)
+#else
 #define PROCESS(name, strname)                   \
   PROCESS_THREAD(name, ev, data);                \
-  struct process name = { NULL, NULL, strname,   \
-                          &process_thread_##name }
+  PROCESS_DESC(name, strname);                   \
+  struct process name = { NULL, NULL, &process_desc_##name }
+#endif
+
+/**
+ * Declare a process with a mailbox of \a size events.
+ *
+ * With PROCESS_CONF_MAILBOXES events posted to a specific process are
+ * kept in a mailbox owned by the receiving process.  Without
+ * PROCESS_CONF_MAILBOXES this is the same as PROCESS().
+ *
+ * \param name The variable name of the process structure.
+ * \param strname The string representation of the process' name.
+ * \param size Number of mailbox slots, power of 2, max 128.
+ *
+ * \hideinitializer
+ */
+#if PROCESS_CONF_MAILBOXES
+#define PROCESS_WITH_MAILBOX(name, strname, size)               \
+  PROCESS_THREAD(name, ev, data);                               \
+  PROCESS_DESC(name, strname);                                  \
+  static struct process_mail process_mail_##name[size];         \
+  struct process name = { NULL, NULL, &process_desc_##name,     \
+                          { process_mail_##name, (size) - 1 } }
+#else
+#define PROCESS_WITH_MAILBOX(name, strname, size)  PROCESS(name, strname)
+#endif
 
 /** @} */
 
+#if PROCESS_CONF_FAIRNESS
+/**
+ * Per process state and metrics of the fair dispatcher.
+ */
+struct process_fairness {
+  uint8_t weight;               /**< dispatches per round, 0 is treated as 1 */
+  uint8_t credits;              /**< dispatches left in the current round */
+  uint8_t deferred;             /**< process has pending work but no credits */
+  uint16_t deferrals;           /**< number of times the process had to wait for a new round */
+  uint32_t dispatches;          /**< number of events and polls delivered to the process */
+  clock_time_t deferred_since;  /**< time of the current deferral */
+  clock_time_t max_starvation;  /**< longest deferral in clock ticks */
+};
+#endif
+
+#if PROCESS_CONF_BUDGET
+/**
+ * Per process usage of the dispatch time budget.
+ */
+struct process_budget {
+  uint32_t total_us;            /**< time spent in all dispatches */
+  uint32_t max_us;              /**< longest dispatch */
+  uint16_t yields;              /**< yields by PROCESS_YIELD_IF_OVER_BUDGET() */
+  uint16_t overruns;            /**< dispatches which returned after the budget was used up */
+};
+#endif
+
+#if PROCESS_CONF_MAILBOXES
+/**
+ * Slot of a process mailbox.
+ */
+struct process_mail {
+  process_event_t ev;
+  process_data_t data;
+};
+
+/**
+ * Mailbox of a process: ring buffer of events and link in the ready list
+ * of processes with pending mail.
+ */
+struct process_mailbox {
+  struct process_mail *slots;
+  uint8_t mask;                 /**< number of slots - 1 */
+  uint8_t first;                /**< index of the oldest event */
+  uint8_t n;                    /**< number of events in the mailbox */
+  uint8_t ready;                /**< process is in the ready list */
+  struct process *ready_next;
+};
+#endif
+
+#if PROCESS_CONF_CHILDREN
+/**
+ * A child protothread, see PROCESS_SPAWN_CHILD().
+ */
+struct process_child {
+  struct pt pt;                 /**< must be the first member */
+  PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
+  struct process_child *parent; /**< NULL if spawned by the process itself */
+  void *arg;
+  uint8_t running;
+};
+#endif
+
+struct etimer;
+
+/**
+ * Hook which is called when a process exits, see process_add_exit_hook().
+ */
+struct process_exit_hook {
+  struct process_exit_hook *next;
+  void (*f)(struct process *p);     /**< called with the exiting process */
+};
+
+/**
+ * Constant part of a process, see PROCESS_DESC().
+ */
+struct process_desc {
+#if !PROCESS_CONF_NO_PROCESS_NAMES
+  const char *name;
+#endif
+  PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
+};
+
 /**
  * Structure used for keeping the queue of processes.
+ *
+ * Only the mutable state is kept here, name and thread are in the
+ * constant struct process_desc.  Pointers come first and the small
+ * members last, so there is no padding in between.
  */
 struct process {
   struct process *next;
   struct pt_sem *sem_owning;
-  const char *name;
-  PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
+  const struct process_desc *desc;
+#if PROCESS_CONF_MAILBOXES
+  struct process_mailbox mbox;
+#endif
+#if PROCESS_CONF_CHILDREN
+  struct process_child *child;  /**< innermost running child */
+#endif
+#if PROCESS_CONF_LAZY_START
+  process_data_t lazy_arg;      /**< argument for the deferred PROCESS_EVENT_INIT */
+#endif
+#if PROCESS_PAUSE_QUEUE
+  struct process *pause_next;
+#endif
+#if PROCESS_CONF_FAIRNESS
+  struct process_fairness fair;
+#endif
+#if PROCESS_CONF_BUDGET
+  struct process_budget budget;
+#endif
+  struct etimer *timers;        /**< armed etimers of the process, see etimer_first_owned() */
   struct pt pt;
-  unsigned char state, needspoll;
+  uint16_t ntimers;             /**< number of armed etimers */
+#if PROCESS_PAUSE_QUEUE
+  uint16_t pause_seq;           /**< position of the pause in the event queue */
+#endif
+  /** set by process_poll() which may be called from interrupts, so not part of the bit field */
+  unsigned char needspoll;
+#if PROCESS_CONF_COMPACT_EVENTS
+  uint8_t index;                /**< position in the process table */
+#endif
+  unsigned char state : 2;
+#if PROCESS_PAUSE_QUEUE
+  unsigned char paused : 1;
+#endif
+#if PROCESS_CONF_LAZY_START
+  unsigned char lazy : 1;       /**< PROCESS_EVENT_INIT is still pending */
+#endif
 };
 
+/**
+ * \name Scheduler contexts
+ *
+ * All state of the scheduler - process list, event queue, polls,
+ * tasklets, etimer and ctimer lists - is kept in a struct
+ * process_context.  The functions of the process, etimer and ctimer
+ * modules operate on the selected context, which is the default
+ * context unless another one has been selected with
+ * process_context_select().
+ *
+ * Without PROCESS_CONF_CONTEXTS only the default context exists and is
+ * addressed statically, which costs exactly the same as the former file
+ * scope variables.
+ *
+ * A process and its timers belong to the context in which they have been
+ * started resp. set.
+ * @{
+ */
+
+/**
+ * Slot of the event queue.
+ *
+ * With PROCESS_CONF_COMPACT_EVENTS the receiver is an index into the
+ * process table of the context and the data pointer is split into
+ * halfwords, so the slot has no padding and is 16 bit aligned.
+ */
+#if PROCESS_CONF_COMPACT_EVENTS
+struct process_event_slot {
+  uint16_t data[sizeof(process_data_t) / 2];
+  uint8_t p;
+  process_event_t ev;
+};
+#else
+struct process_event_slot {
+  process_event_t ev;
+  process_data_t data;
+  struct process *p;
+};
+#endif
+
+/**
+ * An event of the queue, see process_event_peek().
+ */
+struct process_queued_event {
+  process_event_t ev;
+  process_data_t data;
+  struct process *p;
+};
+
+/**
+ * State of one scheduler.  Do not access the members directly.
+ */
+struct process_context {
+#if PROCESS_CONF_CONTEXTS
+  struct process *list;                 /**< process_list while the context is not selected */
+  struct process *current;              /**< process_current while the context is not selected */
+#endif
+#if PROCESS_CONF_COMPACT_EVENTS
+  struct process *table[PROCESS_CONF_MAX_PROCESSES];   /**< running processes by index */
+#endif
+#if PROCESS_CONF_CONTEXTS
+  struct process_event_slot *event_buf;
+  uint16_t event_mask;
+#endif
+  uint16_t nevents, fevent;
+  volatile uint16_t poll_requested;
+  process_event_t lastevent;
+  uint8_t initialized;
+#if PROCESS_CONF_STATS
+  uint16_t maxevents;
+  uint16_t inits;                       /**< number of PROCESS_EVENT_INIT deliveries */
+  uint32_t init_us;                     /**< time spent handling PROCESS_EVENT_INIT */
+#endif
+#if PROCESS_CONF_MAILBOXES
+  struct process *ready_head;           /**< processes with pending mail */
+  struct process *ready_tail;
+  uint16_t nmail;                       /**< events in all mailboxes */
+  uint8_t broadcast_turn;               /**< next event is taken from the broadcast queue */
+#endif
+#if PROCESS_PAUSE_QUEUE
+  struct process *pause_head;           /**< paused processes in order of process_pause() */
+  struct process *pause_tail;
+  uint16_t npaused;
+#endif
+#if PROCESS_PAUSE_QUEUE  ||  ETIMER_CONF_DIRECT_DELIVERY
+  uint16_t deliver_seq;                 /**< number of events taken from the queue */
+#endif
+#if ETIMER_CONF_DIRECT_DELIVERY
+  struct etimer *expired_head;          /**< expired etimers in order of expiry, see process_post_timer() */
+  struct etimer *expired_tail;
+  uint16_t nexpired;
+#if PROCESS_CONF_STATS
+  uint16_t maxexpired;
+#endif
+#endif
+#if PROCESS_CONF_BUDGET
+  uint32_t budget_start;                /**< clock_usecs() at begin of the current dispatch */
+  uint32_t budget;                      /**< time budget of a dispatch in microseconds */
+#endif
+#if PROCESS_CONF_FAIRNESS
+  uint32_t fair_rounds;
+  uint8_t fair_blocked;                 /**< pending work has been deferred in this process_run() */
+  uint8_t fair_dispatched;              /**< something has been dispatched in this process_run() */
+#endif
+
+  struct tasklet_queue tasklets;
+
+  struct etimer_queue etimers;
+  clock_time_t next_expiration;
+#if PROCESS_CONF_NOW_SNAPSHOT
+  clock_time_t now;                     /**< clock snapshot of the current round, see process_now() */
+  uint8_t now_state;                    /**< outside of a round, snapshot pending, snapshot taken */
+#endif
+#if PROCESS_CONF_STATS
+  uint32_t clock_reads;                 /**< clock_time() calls by process_now() */
+  uint32_t clock_reads_saved;           /**< process_now() calls answered from the snapshot */
+#endif
+
+  void *ctimer_list;
+  uint8_t ctimer_initialized;
+
+#if PROCESS_CONF_CONTEXTS
+  struct process *etimer_process;       /**< etimer_process in the default context, else etimer_proc */
+  struct process *ctimer_process;       /**< ctimer_process in the default context, else ctimer_proc */
+  struct process etimer_proc;
+  struct process ctimer_proc;
+#if PROCESS_CONF_MAILBOXES
+  struct process_mail etimer_mail[PROCESS_CONF_SERVICE_MAILBOX_SIZE];
+  struct process_mail ctimer_mail[PROCESS_CONF_SERVICE_MAILBOX_SIZE];
+#endif
+#endif
+};
+
+extern struct process_context process_default_ctx;
+#if PROCESS_CONF_CONTEXTS
+   extern PROCESS_CONF_CONTEXT_STORAGE struct process_context *process_ctx;
+   /** The selected scheduler context */
+   #define PROCESS_CTX  process_ctx
+#else
+   #define PROCESS_CTX  (&process_default_ctx)
+#endif
+
+#if PROCESS_CONF_CONTEXTS
+/**
+ * Initialize a scheduler context.
+ *
+ * \param ctx       The context.
+ * \param events    Buffer for the event queue.
+ * \param numevents Number of slots in \a events, must be a power of 2.
+ *
+ * \note process_init() must be called after selecting the context, then
+ *       the etimer process of the context is started with
+ *       process_start( etimer_context_process(), NULL ).
+ */
+void process_context_init(struct process_context *ctx,
+                          struct process_event_slot *events, uint16_t numevents);
+
+/**
+ * Select the scheduler context for all following calls.
+ *
+ * process_list and process_current are saved in the previous context
+ * and loaded from \a ctx.
+ *
+ * \param ctx The context, NULL selects the default context.
+ * \return    The previously selected context.
+ */
+struct process_context *process_context_select(struct process_context *ctx);
+#endif
+
+/** @} */
+
 /**
  * \name Functions called from application programs
  * @{
@@ -340,6 +914,41 @@ struct process {
  */
 void process_start(struct process *p, void *arg);
 
+/**
+ * Start a process at a saved protothread continuation.
+ *
+ * The process is put on the process list without PROCESS_EVENT_INIT,
+ * it continues at \a lc with the next event.  Its mailbox is emptied.
+ * Used by hibernate_restore() before the saved events are posted again.
+ *
+ * \param p         A pointer to a process structure.
+ * \param lc        The saved local continuation of the protothread.
+ * \param needspoll Non-zero if a poll request was pending.
+ * \retval zero if the process is running already
+ */
+int16_t process_start_restored(struct process *p, lc_t lc, unsigned char needspoll);
+
+#if PROCESS_CONF_LAZY_START
+/**
+ * Start a process, but defer PROCESS_EVENT_INIT.
+ *
+ * The process is put on the process list, PROCESS_EVENT_INIT is
+ * delivered right before its first event - posted, broadcasted, poll
+ * or etimer.  Boot time is then not spent for processes which are not
+ * needed yet.  A process which exits before it has been initialized
+ * does not get PROCESS_EVENT_EXIT.
+ *
+ * \param p   A pointer to a process structure.
+ * \param arg The argument for the deferred PROCESS_EVENT_INIT.
+ */
+void process_start_lazy(struct process *p, void *arg);
+
+/**
+ * Number of processes whose PROCESS_EVENT_INIT is still deferred.
+ */
+uint16_t process_lazy_pending(void);
+#endif
+
 /**
  * Post an asynchronous event.
  *
@@ -359,7 +968,9 @@ void process_start(struct process *p, void *arg);
  * \attention
  *    In contrast to the original Contiki API, process_post() has no
  *    return value.  In case of an overflow of the event queue a system restart
- *    via System_Reset() will be forced!
+ *    via System_Reset() will be forced!  With PROCESS_CONF_MAILBOXES this
+ *    applies to the mailbox of \a p, use process_mailbox_space() for
+ *    backpressure.
  */
 void process_post(struct process *p, process_event_t ev, void* data);
 
@@ -376,6 +987,28 @@ void process_post(struct process *p, process_event_t ev, void* data);
 void process_post_synch(struct process *p,
 			     process_event_t ev, void* data);
 
+/**
+ * Request PROCESS_EVENT_CONTINUE for the current process, used by
+ * PROCESS_PAUSE() and PROCESS_PAUSE_STRICT().
+ *
+ * The event is delivered in the same order as if it had been posted with
+ * process_post(), i.e. after all events posted before.  With
+ * PROCESS_PAUSE_QUEUE the process is just marked runnable and does not
+ * occupy a slot of the event queue.  A pending request is not repeated.
+ */
+void process_pause(void);
+
+#if PROCESS_CONF_CHILDREN
+/**
+ * Make \a child the innermost child of the current process, used by
+ * PROCESS_SPAWN_CHILD().  The child is run by the scheduler as soon as
+ * the caller waits.
+ */
+void process_child_start(struct process_child *child,
+                         PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t)),
+                         void *arg);
+#endif
+
 /**
  * \brief      Cause a process to exit
  * \param p    The process that is to be exited
@@ -389,6 +1022,22 @@ void process_post_synch(struct process *p,
 void process_exit(struct process *p);
 
 
+/**
+ * Register a hook which is called for every exiting process.
+ *
+ * Services which keep resources of processes (timers, semaphores, ...)
+ * release them in the hook.  The hooks are called directly, so processes
+ * which do not care are not involved in an exit.  They are called before
+ * the process receives PROCESS_EVENT_EXIT, while the memory of its
+ * resources is still valid, and once more after it for the resources
+ * acquired while handling the event.  So a hook must be idempotent.
+ * Registering a hook twice is harmless.
+ *
+ * \param hook The hook, must stay valid.
+ */
+void process_add_exit_hook(struct process_exit_hook *hook);
+
+
 /**
  * Get a pointer to the currently running process.
  *
@@ -399,7 +1048,7 @@ void process_exit(struct process *p);
  * \hideinitializer
  */
 #define PROCESS_CURRENT() process_current
-extern struct process *process_current;
+extern PROCESS_CONF_CONTEXT_STORAGE struct process *process_current;
 
 /**
  * Switch context to another process
@@ -476,6 +1125,65 @@ void process_poll(struct process *p);
 
 /** @} */
 
+#if PROCESS_CONF_FAIRNESS
+/**
+ * \name Fair dispatching
+ *
+ * With PROCESS_CONF_FAIRNESS each process gets a budget of \a weight
+ * dispatches (polls and events addressed to it) per round.  A process
+ * which has used up its budget is skipped by do_poll() and do_event()
+ * while other processes have pending work; its events stay queued in
+ * order.  A new round starts when no pending work can be dispatched
+ * anymore.  At each new round the process list is rotated, so that the
+ * order of polls and broadcasts changes as well.
+ *
+ * Broadcast events are not subject to the budget.
+ * @{
+ */
+
+/**
+ * Set the number of dispatches per round for process \a p.
+ *
+ * \param p      The process.
+ * \param weight Dispatches per round, 0 is treated as 1 (default).
+ */
+void process_set_weight(struct process *p, uint8_t weight);
+
+/**
+ * Number of rounds of the fair dispatcher so far.
+ */
+uint32_t process_fair_rounds(void);
+
+/** @} */
+#endif
+
+#if PROCESS_CONF_BUDGET
+/**
+ * \name Dispatch time budget
+ *
+ * With PROCESS_CONF_BUDGET the scheduler measures each dispatch with
+ * clock_usecs() and accounts it in the struct process_budget of the
+ * process.  Long running processes call PROCESS_YIELD_IF_OVER_BUDGET()
+ * in their loops and yield only if the dispatch took longer than the
+ * budget.
+ * @{
+ */
+
+/**
+ * Set the time budget of one dispatch in the selected context.
+ *
+ * \param us Budget in microseconds, default is PROCESS_CONF_BUDGET_US.
+ */
+void process_set_budget(uint32_t us);
+
+/**
+ * Print the budget usage of all running processes with CONTIKI_PRINTF().
+ */
+void process_budget_report(void);
+
+/** @} */
+#endif
+
 /**
  * \name Functions called by the system and boot-up code
  * @{
@@ -493,17 +1201,33 @@ void process_init(void);
  * Run the system once - call poll handlers and process one event.
  *
  * This function should be called repeatedly from the main() program
- * to actually run the Contiki system. It calls the necessary poll
- * handlers, and processes one event. The function returns the number
+ * to actually run the Contiki system. It delivers expired etimers
+ * (see ETIMER_CONF_SCHEDULER_EXPIRY), calls the necessary poll
+ * handlers, executes pending \ref tasklet "tasklets" and processes
+ * one event. The function returns the number
  * of events that are waiting in the event queue so that the caller
  * may choose to put the CPU to sleep when there are no pending
  * events.
  *
  * \return The number of events that are currently waiting in the
- * event queue.
+ * event queue (including pending polls and tasklets).
  */
 uint16_t process_run(void);
 
+/**
+ * The current time for checks made by the scheduler and the timer modules.
+ *
+ * With PROCESS_CONF_NOW_SNAPSHOT the clock is read at the first call in
+ * a process_run() round and the value is returned for the rest of the
+ * round.  The snapshot may lag the clock by the duration of the round,
+ * so an expiry check against it is never early, but a new timer must
+ * be started from clock_time().  Outside of process_run() and without
+ * PROCESS_CONF_NOW_SNAPSHOT this is clock_time().
+ *
+ * \return The current clock time, measured in system ticks.
+ */
+clock_time_t process_now(void);
+
 
 /**
  * Check if a process is running.
@@ -531,12 +1255,79 @@ uint16_t process_nevents(void);
  */
 uint16_t process_nevents_p(struct process *p);
 
+/**
+ * Event \a i of the event queue, 0 is the one which is delivered next.
+ * Used to take snapshots, see hibernate_save().
+ * \param i Index of the event.
+ * \param e Receives the event.
+ * \retval  zero if less than \a i + 1 events are queued
+ */
+int16_t process_event_peek(uint16_t i, struct process_queued_event *e);
+
+#if PROCESS_CONF_MAILBOXES
+/**
+ * Number of free slots in the mailbox of process \a p.
+ * \param p The process.
+ * \retval  number of events which can be posted to \a p without overflow
+ */
+uint16_t process_mailbox_space(struct process *p);
+#endif
+
+#if ETIMER_CONF_DIRECT_DELIVERY
+/**
+ * Deliver PROCESS_EVENT_TIMER for the expired etimer \a et to \a p,
+ * called by the etimer module.
+ *
+ * The timer is appended to the list of expired timers of the scheduler
+ * and delivered after the events which have been posted to the event
+ * queue before, without occupying a slot of the queue.  An expiry which
+ * has not been delivered yet is not repeated.  PROCESS_BROADCAST is
+ * posted to the event queue.
+ * \retval zero if the previous expiry of \a et has not been delivered yet
+ */
+int16_t process_post_timer(struct process *p, struct etimer *et);
+
+/**
+ * Drop the undelivered expiry of \a et, called by etimer_stop().
+ */
+void process_cancel_timer(struct etimer *et);
+
+/**
+ * Check if the expiry of \a et awaits delivery, see process_post_timer().
+ */
+int16_t process_timer_pending(struct etimer *et);
+#endif
+
 /** @} */
 
-extern struct process *process_list;
+extern PROCESS_CONF_CONTEXT_STORAGE struct process *process_list;
 
 #define PROCESS_LIST() process_list
 
+#if PROCESS_CONF_STATS
+/**
+ * \name Statistics of the selected context
+ * @{
+ */
+/** Maximum number of events in the queue so far */
+uint16_t process_maxevents(void);
+/** Number of processes initialized so far */
+uint16_t process_inits(void);
+/** Time spent in PROCESS_EVENT_INIT handlers so far in microseconds, see clock_usecs() */
+uint32_t process_init_us(void);
+#if ETIMER_CONF_DIRECT_DELIVERY
+/** Maximum number of expired etimers awaiting delivery so far */
+uint16_t process_maxexpired(void);
+#endif
+/** Number of clock reads by process_now() */
+uint32_t process_clock_reads(void);
+/** Number of process_now() calls answered from the snapshot of the round */
+uint32_t process_clock_reads_saved(void);
+/** Clear the statistics above */
+void process_stats_reset(void);
+/** @} */
+#endif
+
 
 #ifdef __cplusplus
     }
@@ -214,14 +214,14 @@ struct pt_sem {
 #define PT_SEM_WAIT(PT, SEM)                                                        \
     do {                                                                            \
         if ((SEM)->count > 0) {                                                     \
-            PT_SEM_DEBUGPRINTF( "PT_SEM_WAIT(%x): got semaphore for '%s', %d\n", SEM, PROCESS_CURRENT()->name, PROCESS_CURRENT()->pt.lc ); \
+            PT_SEM_DEBUGPRINTF( "PT_SEM_WAIT(%x): got semaphore for '%s', %d\n", SEM, PROCESS_NAME_STRING(PROCESS_CURRENT()), PROCESS_CURRENT()->pt.lc ); \
             --(SEM)->count;                                                         \
             BTSI_ASSERT( PROCESS_CURRENT()->sem_owning == NULL );                   \
             PROCESS_CURRENT()->sem_owning = SEM;                                    \
             (SEM)->lastBlock = clock_time();                                        \
             break;                                                                  \
         }                                                                           \
-        PT_SEM_DEBUGPRINTF( "PT_SEM_WAIT(%x): blocking '%s', %d\n", SEM, PROCESS_CURRENT()->name, PROCESS_CURRENT()->pt.lc ); \
+        PT_SEM_DEBUGPRINTF( "PT_SEM_WAIT(%x): blocking '%s', %d\n", SEM, PROCESS_NAME_STRING(PROCESS_CURRENT()), PROCESS_CURRENT()->pt.lc ); \
         if ((SEM)->firstBlocked == NULL) {                                          \
             (SEM)->firstBlocked = PROCESS_CURRENT();                                \
         }                                                                           \
@@ -254,19 +254,19 @@ struct pt_sem {
         ++(SEM)->count;                                                         \
         PROCESS_CURRENT()->sem_owning = NULL;                                   \
         if ((SEM)->firstBlocked != NULL) {                                      \
-            PT_SEM_DEBUGPRINTF( "PT_SEM_SIGNAL(%x) released semaphore for '%s', %d SINGLE unblocking, try '%s'\n", SEM, PROCESS_CURRENT()->name, PROCESS_CURRENT()->pt.lc, (SEM)->firstBlocked->name ); \
+            PT_SEM_DEBUGPRINTF( "PT_SEM_SIGNAL(%x) released semaphore for '%s', %d SINGLE unblocking, try '%s'\n", SEM, PROCESS_NAME_STRING(PROCESS_CURRENT()), PROCESS_CURRENT()->pt.lc, PROCESS_NAME_STRING((SEM)->firstBlocked) ); \
             process_post( (SEM)->firstBlocked, PROCESS_EVENT_SEMSIGNAL, SEM );  \
             (SEM)->firstBlocked = NULL;                                         \
             pause = true;                                                       \
         }                                                                       \
         else if ((SEM)->unlockWithBroadcast) {                                  \
-            PT_SEM_DEBUGPRINTF( "PT_SEM_SIGNAL(%x) released semaphore for '%s', %d BROADCAST unblock\n", SEM, PROCESS_CURRENT()->name, PROCESS_CURRENT()->pt.lc ); \
+            PT_SEM_DEBUGPRINTF( "PT_SEM_SIGNAL(%x) released semaphore for '%s', %d BROADCAST unblock\n", SEM, PROCESS_NAME_STRING(PROCESS_CURRENT()), PROCESS_CURRENT()->pt.lc ); \
             process_post( PROCESS_BROADCAST, PROCESS_EVENT_SEMSIGNAL, SEM );    \
             (SEM)->unlockWithBroadcast = 0;                                     \
             pause = true;                                                       \
         }                                                                       \
         else {                                                                  \
-            PT_SEM_DEBUGPRINTF( "PT_SEM_SIGNAL(%x) released semaphore for '%s', %d NOBODY to unblock\n", SEM, PROCESS_CURRENT()->name, PROCESS_CURRENT()->pt.lc ); \
+            PT_SEM_DEBUGPRINTF( "PT_SEM_SIGNAL(%x) released semaphore for '%s', %d NOBODY to unblock\n", SEM, PROCESS_NAME_STRING(PROCESS_CURRENT()), PROCESS_CURRENT()->pt.lc ); \
         }                                                                       \
         if (pause) {                                                            \
             process_post( PROCESS_CURRENT(), PROCESS_EVENT_SEMSIGNAL, SEM );    \
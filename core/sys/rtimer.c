@@ -0,0 +1,152 @@
+/**
+ * \addtogroup rtimer
+ * @{
+ */
+
+/**
+ * \file
+ * Real-time timer implementation.
+ *
+ * The scheduled timers are kept in a list sorted by deadline, the
+ * hardware alarm is programmed for the head of the list.  The list is
+ * shared between process and interrupt context, so all changes are made
+ * under rtimer_arch_lock().  Callbacks are called without the lock, so
+ * they may schedule timers again.
+ */
+
+#include <stddef.h>
+#include "sys/rtimer.h"
+
+static struct rtimer *rtimer_list;
+
+#if PROCESS_CONF_STATS
+struct rtimer_stats rtimer_stats;
+#endif
+
+/*---------------------------------------------------------------------------*/
+static int16_t unlink_rtimer(struct rtimer *rt)
+/**
+ * Remove \a rt from the list, return non-zero if it was scheduled.
+ * Called with the lock held.
+ */
+{
+   struct rtimer **pp;
+
+   for (pp = &rtimer_list;  *pp != NULL;  pp = &(*pp)->next) {
+      if (*pp == rt) {
+         *pp = rt->next;
+         return 1;
+      }
+   }
+   return 0;
+}
+/*---------------------------------------------------------------------------*/
+void rtimer_init(void)
+{
+   rtimer_list = NULL;
+#if PROCESS_CONF_STATS
+   rtimer_stats_reset();
+#endif
+   rtimer_arch_init();
+}
+/*---------------------------------------------------------------------------*/
+void rtimer_set(struct rtimer *rt, rtimer_clock_t time, rtimer_callback_t func, void *ptr)
+{
+   struct rtimer **pp;
+   uint32_t state;
+
+   state = rtimer_arch_lock();
+   unlink_rtimer(rt);
+
+   rt->time = time;
+   rt->func = func;
+   rt->ptr = ptr;
+
+   /* behind timers with the same deadline */
+   for (pp = &rtimer_list;  *pp != NULL  &&  !RTIMER_CLOCK_LT(time, (*pp)->time);  pp = &(*pp)->next) {
+   }
+   rt->next = *pp;
+   *pp = rt;
+
+   if (rtimer_list == rt) {
+      rtimer_arch_schedule(time);
+   }
+   rtimer_arch_unlock(state);
+}
+/*---------------------------------------------------------------------------*/
+void rtimer_cancel(struct rtimer *rt)
+{
+   uint32_t state;
+
+   /* the alarm of a cancelled head finds nothing due and is reprogrammed */
+   state = rtimer_arch_lock();
+   unlink_rtimer(rt);
+   rtimer_arch_unlock(state);
+}
+/*---------------------------------------------------------------------------*/
+int16_t rtimer_pending(struct rtimer *rt)
+{
+   struct rtimer *t;
+   uint32_t state;
+
+   state = rtimer_arch_lock();
+   for (t = rtimer_list;  t != NULL  &&  t != rt;  t = t->next) {
+   }
+   rtimer_arch_unlock(state);
+   return t != NULL;
+}
+/*---------------------------------------------------------------------------*/
+void rtimer_run_next(void)
+{
+   for (;;) {
+      struct rtimer *rt;
+      rtimer_clock_t now;
+      uint32_t state;
+
+      state = rtimer_arch_lock();
+      rt = rtimer_list;
+      now = rtimer_arch_now();
+      if (rt == NULL  ||  RTIMER_CLOCK_LT(now, rt->time)) {
+         if (rt != NULL) {
+            rtimer_arch_schedule(rt->time);
+         }
+         rtimer_arch_unlock(state);
+         return;
+      }
+      rtimer_list = rt->next;
+      rtimer_arch_unlock(state);
+
+#if PROCESS_CONF_STATS
+      {
+         rtimer_clock_t late = now - rt->time;
+
+         if (rtimer_stats.runs == 0  ||  late < rtimer_stats.late_min) {
+            rtimer_stats.late_min = late;
+         }
+         if (late > rtimer_stats.late_max) {
+            rtimer_stats.late_max = late;
+         }
+         rtimer_stats.late_sum += late;
+         ++rtimer_stats.runs;
+      }
+#endif
+      rt->func(rt, rt->ptr);
+   }
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_STATS
+void rtimer_stats_reset(void)
+{
+   uint32_t state;
+
+   state = rtimer_arch_lock();
+   rtimer_stats.runs = 0;
+   rtimer_stats.late_min = 0;
+   rtimer_stats.late_max = 0;
+   rtimer_stats.late_sum = 0;
+   rtimer_arch_unlock(state);
+}
+#endif
+/*---------------------------------------------------------------------------*/
+
+/** @} */
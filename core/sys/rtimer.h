@@ -0,0 +1,168 @@
+/**
+ * \addtogroup sys
+ * @{
+ */
+
+/**
+ * \defgroup rtimer Real-time timers
+ * @{
+ *
+ * Real-time timers call a function at a deadline given in microseconds.
+ * The function is called directly from the interrupt of the hardware
+ * alarm of the port, without going through etimer_process, the event
+ * queue or ctimer_process, so the resolution is not limited by
+ * CLOCK_SECOND and the jitter is the interrupt latency.  Meant for
+ * bit-banged protocols and sampling.
+ *
+ * Any number of rtimers can be scheduled, they are kept in a list sorted
+ * by deadline and the hardware alarm is programmed for the first one.
+ * The callback runs in interrupt context: it must be short, it must not
+ * call the process API except process_poll() and
+ * tasklet_schedule_from_isr(), and it may schedule rtimers again, e.g.
+ * itself for the next period.
+ *
+ * A port provides the rtimer_arch_xxx() functions and calls
+ * rtimer_run_next() from its alarm interrupt.
+ */
+
+/**
+ * \file
+ * Header file for the real-time timers.
+ */
+
+#ifndef __RTIMER_H__
+#define __RTIMER_H__
+
+#include <stdint.h>
+#include "contiki-conf.h"
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif //__cplusplus
+
+/** Time of the real-time timers in microseconds, wraps after 71 minutes */
+typedef uint32_t rtimer_clock_t;
+
+/** A second, measured in rtimer_clock_t */
+#define RTIMER_SECOND           1000000UL
+
+/** The current real-time clock */
+#define RTIMER_NOW()            rtimer_arch_now()
+
+/**
+ * Check if a real-time clock value is less than another one, see \ref CLOCK_A_LT_B().
+ *
+ * \retval true if a < b
+ */
+#define RTIMER_CLOCK_LT(a, b)   ((int32_t)((a) - (b)) < 0)
+
+struct rtimer;
+
+/** Callback of a real-time timer, called in interrupt context */
+typedef void (*rtimer_callback_t)(struct rtimer *rt, void *ptr);
+
+/**
+ * A real-time timer.
+ *
+ * \hideinitializer
+ */
+struct rtimer {
+  struct rtimer *next;
+  rtimer_clock_t time;          /**< deadline */
+  rtimer_callback_t func;
+  void *ptr;
+};
+
+#if PROCESS_CONF_STATS
+/**
+ * Lateness of the callbacks, i.e. RTIMER_NOW() at the call minus the deadline.
+ */
+struct rtimer_stats {
+  uint32_t runs;                /**< callbacks called */
+  rtimer_clock_t late_min;      /**< smallest lateness [us] */
+  rtimer_clock_t late_max;      /**< largest lateness [us] */
+  uint32_t late_sum;            /**< sum of the lateness [us], for the average */
+};
+
+extern struct rtimer_stats rtimer_stats;
+#endif
+
+/**
+ * \brief      Initialize the real-time timers and the hardware alarm of the port.
+ */
+void rtimer_init(void);
+
+/**
+ * \brief      Schedule a real-time timer.
+ * \param rt   A pointer to the timer
+ * \param time The deadline, an absolute time, e.g. RTIMER_NOW() + 100.
+ * \param func The function called at the deadline.
+ * \param ptr  The argument of \a func.
+ *
+ *             A scheduled timer is rescheduled.  A deadline in the past
+ *             calls \a func from the alarm interrupt as soon as possible.
+ *             May be called from process and from interrupt context.
+ */
+void rtimer_set(struct rtimer *rt, rtimer_clock_t time, rtimer_callback_t func, void *ptr);
+
+/**
+ * \brief      Cancel a scheduled real-time timer.
+ * \param rt   A pointer to the timer
+ */
+void rtimer_cancel(struct rtimer *rt);
+
+/**
+ * \brief      Check if a real-time timer is scheduled.
+ * \param rt   A pointer to the timer
+ * \return     Non-zero if the callback has not been called yet.
+ */
+int16_t rtimer_pending(struct rtimer *rt);
+
+#if PROCESS_CONF_STATS
+/**
+ * \brief      Clear the lateness statistics.
+ */
+void rtimer_stats_reset(void);
+#endif
+
+/**
+ * \name Port interface
+ * @{
+ */
+
+/** Claim and set up the hardware alarm.  Called by rtimer_init(). */
+void rtimer_arch_init(void);
+
+/** The current time of the free running microsecond counter of the alarm. */
+rtimer_clock_t rtimer_arch_now(void);
+
+/**
+ * Program the hardware alarm for \a time, replacing the previous
+ * deadline.  A deadline in the past must raise the alarm interrupt
+ * immediately.  Called with the lock held.
+ */
+void rtimer_arch_schedule(rtimer_clock_t time);
+
+/** Lock out the alarm interrupt, return the state for rtimer_arch_unlock().  Nestable. */
+uint32_t rtimer_arch_lock(void);
+
+/** Restore the state returned by rtimer_arch_lock(). */
+void rtimer_arch_unlock(uint32_t state);
+
+/**
+ * Call the callbacks of the due timers and program the alarm for the
+ * next one.  Called by the port from the alarm interrupt.
+ */
+void rtimer_run_next(void);
+
+/** @} */
+
+#ifdef __cplusplus
+    }
+#endif //__cplusplus
+
+#endif /* __RTIMER_H__ */
+
+/** @} */
+/** @} */
@@ -0,0 +1,88 @@
+/**
+ * \addtogroup stimer
+ * @{
+ */
+
+/**
+ * \file
+ * Seconds timer library implementation.
+ */
+
+#include "contiki-conf.h"
+#include "sys/clock.h"
+#include "sys/stimer.h"
+
+/*---------------------------------------------------------------------------*/
+/**
+ * Set a seconds timer.
+ *
+ * \param t A pointer to the timer
+ * \param interval The interval before the timer expires, in seconds.
+ */
+void stimer_set(struct stimer *t, uint32_t interval)
+{
+   t->interval = interval;
+   t->start = clock_seconds();
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Reset the timer with the same interval, without drift.
+ *
+ * \param t A pointer to the timer.
+ *
+ * \sa stimer_restart()
+ */
+void stimer_reset(struct stimer *t)
+{
+   t->start += t->interval;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Restart the timer from the current point in time.
+ *
+ * \param t A pointer to the timer.
+ *
+ * \sa stimer_reset()
+ */
+void stimer_restart(struct stimer *t)
+{
+   t->start = clock_seconds();
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Check if a seconds timer has expired.
+ *
+ * \param t A pointer to the timer
+ *
+ * \return Non-zero if the timer has expired, zero otherwise.
+ *
+ * An expired timer stays expired for 68 years.
+ */
+int16_t stimer_expired(struct stimer *t)
+{
+   return STIMER_A_GE_B(clock_seconds(), t->start + t->interval);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Return the number of seconds until the timer expires, or zero if already expired
+ */
+uint32_t stimer_remaining(struct stimer *t)
+{
+   uint32_t now = clock_seconds();
+
+   if (STIMER_A_GE_B(now, t->start + t->interval)) {
+      return 0;
+   }
+   return (t->start + t->interval) - now;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Return the number of seconds since the timer was started.
+ */
+uint32_t stimer_elapsed(struct stimer *t)
+{
+   return clock_seconds() - t->start;
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
@@ -0,0 +1,74 @@
+/**
+ * \addtogroup sys
+ * @{
+ */
+
+/**
+ * \defgroup stimer Seconds timer library
+ * @{
+ *
+ * The seconds timer library works like the \ref timer "timer library",
+ * but measures time in seconds with clock_seconds().  It is meant for
+ * long intervals like maintenance periods or lease times: intervals up
+ * to 68 years can be compared with 32 bit arithmetic, so a timer may be
+ * left unattended for months without becoming unexpired again.
+ *
+ * \sa \ref timer "Timer library"
+ */
+
+/**
+ * \file
+ * Seconds timer library header file.
+ */
+
+#ifndef __STIMER_H__
+#define __STIMER_H__
+
+#include "sys/clock.h"
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif //__cplusplus
+
+/**
+ * Check if a seconds value is less than another one, see \ref CLOCK_A_LT_B().
+ *
+ * \retval true if a < b
+ */
+#define STIMER_A_LT_B(a, b) ((int32_t)((a) - (b)) < 0)
+
+/**
+ * Check if a seconds value is greater or equal than another one.
+ *
+ * \retval true if a >= b
+ */
+#define STIMER_A_GE_B(a, b) ((int32_t)((a) - (b)) >= 0)
+
+/**
+ * A seconds timer.
+ *
+ * The timer must be set with stimer_set() before it can be used.
+ *
+ * \hideinitializer
+ */
+struct stimer {
+  uint32_t start;
+  uint32_t interval;
+};
+
+void stimer_set(struct stimer *t, uint32_t interval);
+void stimer_reset(struct stimer *t);
+void stimer_restart(struct stimer *t);
+int16_t stimer_expired(struct stimer *t);
+uint32_t stimer_remaining(struct stimer *t);
+uint32_t stimer_elapsed(struct stimer *t);
+
+#ifdef __cplusplus
+    }
+#endif //__cplusplus
+
+#endif /* __STIMER_H__ */
+
+/** @} */
+/** @} */
@@ -0,0 +1,151 @@
+/**
+ * \addtogroup tasklet
+ * @{
+ */
+
+/**
+ * \file
+ * Tasklet implementation.
+ *
+ * Tasklets from process context are kept in a FIFO list with tail
+ * pointer, items come from a fixed pool with free list.  Tasklets from
+ * interrupt context are kept in a single producer / single consumer
+ * ring buffer, so neither side has to lock interrupts.  All state lives
+ * in the selected scheduler context.
+ */
+
+#include <assert.h>
+#include "sys/tasklet.h"
+#include "sys/process.h"
+
+#if (TASKLET_CONF_ISR_NUM & (TASKLET_CONF_ISR_NUM-1)) != 0
+   #error "TASKLET_CONF_ISR_NUM must be a power of 2"
+#endif
+
+/*---------------------------------------------------------------------------*/
+void tasklet_init(void)
+{
+   struct tasklet_queue *tq = &PROCESS_CTX->tasklets;
+   uint16_t i;
+
+   tq->free_list = NULL;
+   for (i = 0;  i < TASKLET_CONF_NUM;  ++i) {
+      tq->pool[i].next = tq->free_list;
+      tq->free_list = &tq->pool[i];
+   }
+   tq->head = NULL;
+   tq->tail = &tq->head;
+   tq->npending = 0;
+   tq->isr_head = tq->isr_tail = 0;
+#if PROCESS_CONF_STATS
+   tq->overruns = 0;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+int16_t tasklet_schedule(void (*f)(void *), void *ptr)
+{
+   struct tasklet_queue *tq = &PROCESS_CTX->tasklets;
+   struct tasklet *t;
+
+   assert( !CONTIKI_IN_ISR() );
+   assert( tq->tail != NULL );
+
+   t = tq->free_list;
+   if (t == NULL) {
+#if PROCESS_CONF_STATS
+      ++tq->overruns;
+#endif
+      return 0;
+   }
+   tq->free_list = t->next;
+
+   t->next = NULL;
+   t->p    = PROCESS_CURRENT();
+   t->f    = f;
+   t->ptr  = ptr;
+   *tq->tail = t;
+   tq->tail = &t->next;
+   ++tq->npending;
+   return 1;
+}
+/*---------------------------------------------------------------------------*/
+int16_t tasklet_schedule_from_isr(void (*f)(void *), void *ptr)
+{
+   /* the selected context means nothing in an interrupt */
+   struct tasklet_queue *tq = &process_default_ctx.tasklets;
+   uint16_t h = tq->isr_head;
+
+   if ((uint16_t)(h - __atomic_load_n(&tq->isr_tail, __ATOMIC_ACQUIRE)) >= TASKLET_CONF_ISR_NUM) {
+#if PROCESS_CONF_STATS
+      ++tq->overruns;
+#endif
+      return 0;
+   }
+   tq->isr_ring[h & (TASKLET_CONF_ISR_NUM - 1)].f   = f;
+   tq->isr_ring[h & (TASKLET_CONF_ISR_NUM - 1)].ptr = ptr;
+   __atomic_store_n(&tq->isr_head, (uint16_t)(h + 1), __ATOMIC_RELEASE);
+   return 1;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t tasklet_pending(void)
+{
+   struct tasklet_queue *tq = &PROCESS_CTX->tasklets;
+
+   return tq->npending + (uint16_t)(__atomic_load_n(&tq->isr_head, __ATOMIC_ACQUIRE) - tq->isr_tail);
+}
+/*---------------------------------------------------------------------------*/
+void tasklet_run(void)
+{
+   struct tasklet_queue *tq = &PROCESS_CTX->tasklets;
+   struct process *caller = PROCESS_CURRENT();
+
+   assert( !CONTIKI_IN_ISR() );
+
+   /* interrupt tasklets first, they are usually the more urgent ones */
+   {
+      uint16_t h = __atomic_load_n(&tq->isr_head, __ATOMIC_ACQUIRE);
+      uint16_t t = tq->isr_tail;
+
+      process_current = NULL;
+      while (t != h) {
+         struct tasklet_isr *it = &tq->isr_ring[t & (TASKLET_CONF_ISR_NUM - 1)];
+         void (*f)(void *) = it->f;
+         void *ptr = it->ptr;
+
+         ++t;
+         __atomic_store_n(&tq->isr_tail, t, __ATOMIC_RELEASE);
+         f( ptr );
+      }
+   }
+
+   /* detach the current list, so that rescheduling tasklets are executed next time */
+   if (tq->head != NULL) {
+      struct tasklet *t = tq->head;
+
+      tq->head = NULL;
+      tq->tail = &tq->head;
+      while (t != NULL) {
+         struct tasklet *next = t->next;
+         void (*f)(void *) = t->f;
+         void *ptr = t->ptr;
+
+         process_current = t->p;
+         t->next = tq->free_list;
+         tq->free_list = t;
+         --tq->npending;
+         f( ptr );
+         t = next;
+      }
+   }
+
+   process_current = caller;
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_STATS
+uint16_t tasklet_overruns(void)
+{
+   return PROCESS_CTX->tasklets.overruns;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,147 @@
+/**
+ * \addtogroup sys
+ * @{
+ */
+
+/**
+ * \defgroup tasklet Tasklets
+ * @{
+ *
+ * A tasklet is a function call (function and argument) which is deferred
+ * until the scheduler runs next.  Tasklets are executed by process_run()
+ * after the poll handlers and before the next event is delivered.
+ *
+ * Compared to a ctimer with zero timeout a tasklet needs no etimer,
+ * no slot in the event queue and no ctimer list search: scheduling is
+ * O(1).  Tasklet storage is a fixed pool, so the caller does not have
+ * to provide any memory.
+ *
+ * tasklet_schedule() must be called from process context, the
+ * function is executed in the context of the scheduling process.
+ * tasklet_schedule_from_isr() is lock free and may be used from
+ * interrupt handlers (of one priority level), the function is executed
+ * without process context.
+ */
+
+/**
+ * \file
+ * Header file for tasklets.
+ */
+
+#ifndef __TASKLET_H__
+#define __TASKLET_H__
+
+#include <stdint.h>
+#include "contiki-conf.h"
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif //__cplusplus
+
+#ifndef TASKLET_CONF_NUM
+/** Number of tasklets which can be pending from process context */
+#define TASKLET_CONF_NUM        4
+#endif
+
+#ifndef TASKLET_CONF_ISR_NUM
+/** Number of tasklets which can be pending from interrupt context, must be a power of 2 */
+#define TASKLET_CONF_ISR_NUM    4
+#endif
+
+struct process;
+
+/**
+ * A pending tasklet from process context.
+ */
+struct tasklet {
+  struct tasklet *next;
+  struct process *p;
+  void (*f)(void *);
+  void *ptr;
+};
+
+/**
+ * A pending tasklet from interrupt context.
+ */
+struct tasklet_isr {
+  void (*f)(void *);
+  void *ptr;
+};
+
+/**
+ * Tasklet state of a scheduler context, see struct process_context.
+ */
+struct tasklet_queue {
+  struct tasklet pool[TASKLET_CONF_NUM];
+  struct tasklet *free_list;
+  struct tasklet *head;
+  struct tasklet **tail;
+  uint16_t npending;
+
+  struct tasklet_isr isr_ring[TASKLET_CONF_ISR_NUM];
+  uint16_t isr_head;                  /**< written by the ISR only */
+  uint16_t isr_tail;                  /**< written by tasklet_run() only */
+#if PROCESS_CONF_STATS
+  uint16_t overruns;
+#endif
+};
+
+/**
+ * \brief      Schedule a tasklet.
+ * \param f    The function to be called.
+ * \param ptr  An opaque pointer that will be supplied as an argument to \a f.
+ * \return     Non-zero if the tasklet has been scheduled, zero if the pool is exhausted.
+ *
+ *             \a f will be called with \a ptr from process_run() in the
+ *             context of the current process.  Tasklets are executed in
+ *             the order they have been scheduled.
+ */
+int16_t tasklet_schedule(void (*f)(void *), void *ptr);
+
+/**
+ * \brief      Schedule a tasklet from interrupt context.
+ * \param f    The function to be called.
+ * \param ptr  An opaque pointer that will be supplied as an argument to \a f.
+ * \return     Non-zero if the tasklet has been scheduled, zero if the ISR queue is full.
+ *
+ *             Lock free variant of tasklet_schedule().  \a f will be
+ *             called without process context, i.e. PROCESS_CURRENT() is NULL.
+ *             The tasklet is always run by the default context.
+ */
+int16_t tasklet_schedule_from_isr(void (*f)(void *), void *ptr);
+
+/**
+ * \brief      Number of pending tasklets.
+ */
+uint16_t tasklet_pending(void);
+
+/**
+ * \brief      Execute all tasklets which are pending at the time of the call.
+ *
+ *             Tasklets scheduled by the executed tasklets are run with the
+ *             next call.  Called by process_run().
+ */
+void tasklet_run(void);
+
+/**
+ * \brief      Initialize the tasklet module.  Called by process_init().
+ */
+void tasklet_init(void);
+
+#if PROCESS_CONF_STATS
+/**
+ * \brief      Number of tasklets of the selected context which could not be
+ *             scheduled because the pool / queue was exhausted.
+ */
+uint16_t tasklet_overruns(void);
+#endif
+
+#ifdef __cplusplus
+    }
+#endif //__cplusplus
+
+#endif /* __TASKLET_H__ */
+
+/** @} */
+/** @} */
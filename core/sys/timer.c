@@ -114,18 +114,34 @@ void timer_restart(struct timer *t)
  *
  * \attention
  *   Ensure that an expired timer is not queried far in the future because of time wrapping
- *   the timer might go into unexpired!
+ *   the timer might go into unexpired!  Use a struct timer64 or a struct stimer for
+ *   timers which may be left unattended for weeks.
  */
 int16_t timer_expired(struct timer *t)
 {
-    clock_time_t ct = clock_time();
+    return timer_expired_at(t, clock_time());
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Check if a timer has expired at the given time.
+ *
+ * Like timer_expired(), but compares with \a now instead of reading the
+ * clock, e.g. with the snapshot of process_now().
+ *
+ * \param t A pointer to the timer
+ * \param now The current time
+ *
+ * \return Non-zero if the timer has expired, zero otherwise.
+ */
+int16_t timer_expired_at(struct timer *t, clock_time_t now)
+{
+    clock_time_t ct = now;
     int16_t r;
 
     r = CLOCK_A_GE_B(ct, t->start + t->interval);
-    if (r  &&  t->interval != 0) {
-        while (CLOCK_A_GE_B(ct, t->start + 2*t->interval)) {
-            t->start += t->interval;
-        }
+    if (r  &&  t->interval != 0  &&  CLOCK_A_GE_B(ct, t->start + 2*t->interval)) {
+        // advance to the last period boundary, O(1) after a long stall
+        t->start += ((ct - t->start) / t->interval - 1) * t->interval;
     }
     return r;
 }
@@ -144,10 +160,93 @@ int16_t timer_expired(struct timer *t)
  */
 clock_time_t timer_remaining(struct timer *t)
 {
-   if (timer_expired(t)) {
+   return timer_remaining_at(t, clock_time());
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Return the number of ticks from \a now until a timer expires, or zero if already expired
+ */
+clock_time_t timer_remaining_at(struct timer *t, clock_time_t now)
+{
+   if (timer_expired_at(t, now)) {
+      return 0;
+   }
+   return (t->start + t->interval) - now;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Set a 64 bit timer.
+ *
+ * \param t A pointer to the timer
+ * \param interval The interval before the timer expires.
+ *
+ * \sa timer_set()
+ */
+void timer64_set(struct timer64 *t, clock_time64_t interval)
+{
+   t->interval = interval;
+   t->start = clock_time64();
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Reset the 64 bit timer with the same interval, without drift.
+ *
+ * \param t A pointer to the timer.
+ *
+ * \sa timer_reset()
+ */
+void timer64_reset(struct timer64 *t)
+{
+   t->start += t->interval;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Restart the 64 bit timer from the current point in time.
+ *
+ * \param t A pointer to the timer.
+ *
+ * \sa timer_restart()
+ */
+void timer64_restart(struct timer64 *t)
+{
+   t->start = clock_time64();
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Check if a 64 bit timer has expired.
+ *
+ * \param t A pointer to the timer
+ *
+ * \return Non-zero if the timer has expired, zero otherwise.
+ *
+ * Unlike timer_expired() an expired timer never becomes unexpired.  The
+ * catch-up after a long stall divides 64 bit, this is rare enough to
+ * keep the common path a plain compare.
+ */
+int16_t timer64_expired(struct timer64 *t)
+{
+    clock_time64_t ct = clock_time64();
+    int16_t r;
+
+    r = CLOCK64_A_GE_B(ct, t->start + t->interval);
+    if (r  &&  t->interval != 0  &&  CLOCK64_A_GE_B(ct, t->start + 2*t->interval)) {
+        // advance to the last period boundary, O(1) after a long stall
+        t->start += ((ct - t->start) / t->interval - 1) * t->interval;
+    }
+    return r;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Return the number of ticks until a 64 bit timer expires, or zero if already expired
+ */
+clock_time64_t timer64_remaining(struct timer64 *t)
+{
+   clock_time64_t ct = clock_time64();
+
+   if (CLOCK64_A_GE_B(ct, t->start + t->interval)) {
       return 0;
    }
-   return (t->start + t->interval) - clock_time();
+   return (t->start + t->interval) - ct;
 }
 /*---------------------------------------------------------------------------*/
 
@@ -97,6 +97,28 @@ void timer_reset(struct timer *t);
 void timer_restart(struct timer *t);
 int16_t timer_expired(struct timer *t);
 clock_time_t timer_remaining(struct timer *t);
+int16_t timer_expired_at(struct timer *t, clock_time_t now);
+clock_time_t timer_remaining_at(struct timer *t, clock_time_t now);
+
+/**
+ * A timer with 64 bit clock time.
+ *
+ * Like struct timer, but intervals are not limited to \ref CLOCK_MAX_DELTA
+ * and an expired timer stays expired however late it is queried.  Uses
+ * clock_time64().
+ *
+ * \hideinitializer
+ */
+struct timer64 {
+  clock_time64_t start;
+  clock_time64_t interval;
+};
+
+void timer64_set(struct timer64 *t, clock_time64_t interval);
+void timer64_reset(struct timer64 *t);
+void timer64_restart(struct timer64 *t);
+int16_t timer64_expired(struct timer64 *t);
+clock_time64_t timer64_remaining(struct timer64 *t);
 
 #ifdef __cplusplus
     }
@@ -3,11 +3,15 @@
 #include "contiki.h"
 
 #include <esp32-hal-timer.h>
+#include <esp_timer.h>
 
 
 /* create a hardware timer */
 hw_timer_t * timer = NULL;
 
+/* guards the corrections of the clock */
+static portMUX_TYPE clock_mux = portMUX_INITIALIZER_UNLOCKED;
+
 
 
 /**
@@ -19,11 +23,87 @@ hw_timer_t * timer = NULL;
  */
 clock_time_t clock_time(void)
 {
-    return timerRead( timer );
+#if CLOCK_CONF_ADJUST
+    return (clock_time_t)clock_time64();
+#else
+    return (clock_time_t)timerRead( timer );
+#endif
 }   // clock_time
 
 
 
+/**
+ * Get the current clock time with 64 bit.
+ */
+clock_time64_t clock_time64(void)
+{
+#if CLOCK_CONF_ADJUST
+    uint32_t state = clock_arch_lock();
+    clock_time64_t ticks = clock_adjusted( timerRead( timer ));
+
+    clock_arch_unlock( state );
+    return ticks;
+#else
+    return timerRead( timer );
+#endif
+}   // clock_time64
+
+
+
+/**
+ * Lock the clock against interrupts and the other core.
+ */
+uint32_t clock_arch_lock(void)
+{
+    portENTER_CRITICAL_SAFE( &clock_mux );
+    return 0;
+}   // clock_arch_lock
+
+
+
+/**
+ * Release the lock of the clock.
+ */
+void clock_arch_unlock(uint32_t state)
+{
+    (void)state;
+    portEXIT_CRITICAL_SAFE( &clock_mux );
+}   // clock_arch_unlock
+
+
+
+#if CLOCK_CONF_ADJUST
+/**
+ * Get the clock time with 64 bit without the corrections, the lock is held.
+ */
+clock_time64_t clock_time64_raw(void)
+{
+    return timerRead( timer );
+}   // clock_time64_raw
+#endif
+
+
+
+/**
+ * Get the seconds since the start of the clock.
+ */
+uint32_t clock_seconds(void)
+{
+    return (uint32_t)(timerRead( timer ) / CLOCK_SECOND);
+}   // clock_seconds
+
+
+
+/**
+ * Get a free running microsecond counter.
+ */
+uint32_t clock_usecs(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}   // clock_usecs
+
+
+
 /**
  * Initialize the interrupt system for the next etimer event.
  */
@@ -0,0 +1,76 @@
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <string.h>
+#include <esp_attr.h>
+#include <esp_idf_version.h>
+#include <esp_ota_ops.h>
+#include "sys/hibernate.h"
+
+//
+// The snapshot is kept in RTC slow memory which is not initialized by
+// the runtime, it survives deep sleep.
+//
+
+RTC_NOINIT_ATTR static uint8_t snapshot[HIBERNATE_CONF_SIZE];
+RTC_NOINIT_ATTR static uint16_t snapshot_len;
+RTC_NOINIT_ATTR static uint16_t snapshot_valid;
+
+#define SNAPSHOT_VALID  0xa55a
+
+
+
+/**
+ * Copy the snapshot to RTC memory.
+ */
+int16_t hibernate_port_write( const void *buf, uint16_t len )
+{
+    if (len > sizeof(snapshot)) {
+        return 0;
+    }
+    memcpy( snapshot, buf, len );
+    snapshot_len   = len;
+    snapshot_valid = SNAPSHOT_VALID;
+    return 1;
+}   // hibernate_port_write
+
+
+
+/**
+ * Copy the snapshot from RTC memory.
+ */
+uint16_t hibernate_port_read( void *buf, uint16_t size )
+{
+    if (snapshot_valid != SNAPSHOT_VALID  ||  snapshot_len > size) {
+        return 0;
+    }
+    memcpy( buf, snapshot, snapshot_len );
+    return snapshot_len;
+}   // hibernate_port_read
+
+
+
+void hibernate_port_clear( void )
+{
+    snapshot_valid = 0;
+}   // hibernate_port_clear
+
+
+
+/**
+ * First bytes of the SHA-256 of the ELF file, stored in the image by the
+ * build.
+ */
+uint32_t hibernate_port_build_id( void )
+{
+#if ESP_IDF_VERSION_MAJOR >= 5
+    const esp_app_desc_t *desc = esp_app_get_description();
+#else
+    const esp_app_desc_t *desc = esp_ota_get_app_description();
+#endif
+    uint32_t id;
+
+    memcpy( &id, desc->app_elf_sha256, sizeof(id) );
+    return id;
+}   // hibernate_port_build_id
+
+#endif
@@ -0,0 +1,74 @@
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include "contiki.h"
+
+#include <esp32-hal-timer.h>
+
+//
+// Real-time timers on hardware timer 1 (timer 0 is the clock), counting
+// the 80MHz APB clock divided by 80, i.e. microseconds.  The alarm is
+// written as an absolute counter value.  The callbacks run from the
+// interrupt, so they should be placed in IRAM.
+//
+
+static hw_timer_t *rt_timer = NULL;
+static portMUX_TYPE rt_mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+
+static void IRAM_ATTR alarm_isr( void )
+{
+    rtimer_run_next();
+}   // alarm_isr
+
+
+
+/**
+ * Set up the timer and its interrupt.
+ */
+void rtimer_arch_init( void )
+{
+    if (rt_timer == NULL) {
+        rt_timer = timerBegin( 1, 80, true );
+        timerAttachInterrupt( rt_timer, alarm_isr, true );
+    }
+}   // rtimer_arch_init
+
+
+
+rtimer_clock_t IRAM_ATTR rtimer_arch_now( void )
+{
+    return (rtimer_clock_t)timerRead( rt_timer );
+}   // rtimer_arch_now
+
+
+
+/**
+ * Program the alarm, a missed deadline is moved to the next microsecond.
+ */
+void IRAM_ATTR rtimer_arch_schedule( rtimer_clock_t time )
+{
+    uint64_t now = timerRead( rt_timer );
+    int32_t delta = (int32_t)(time - (uint32_t)now);
+
+    timerAlarmWrite( rt_timer, now + (delta > 1 ? delta : 1), false );
+    timerAlarmEnable( rt_timer );
+}   // rtimer_arch_schedule
+
+
+
+uint32_t IRAM_ATTR rtimer_arch_lock( void )
+{
+    portENTER_CRITICAL_SAFE( &rt_mux );
+    return 0;
+}   // rtimer_arch_lock
+
+
+
+void IRAM_ATTR rtimer_arch_unlock( uint32_t state )
+{
+    (void)state;
+    portEXIT_CRITICAL_SAFE( &rt_mux );
+}   // rtimer_arch_unlock
+
+#endif
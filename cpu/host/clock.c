@@ -0,0 +1,131 @@
+#if !defined(ARDUINO)
+
+#include <pthread.h>
+#include <time.h>
+#include "contiki.h"
+
+//
+// Host stand-in for the clock: CLOCK_MONOTONIC as the microsecond
+// counter.  The lock of the clock is a mutex.  The host has no alarm to
+// program, clock_update() is a no-op as on the targets, where it is not
+// implemented yet.
+//
+
+/* microseconds of the monotonic clock to clock ticks and to seconds */
+static struct clock_conv conv;
+static struct clock_conv_sec conv_sec;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+static uint64_t time_us_64( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}   // time_us_64
+
+
+
+/**
+ * Get the current clock time.
+ */
+clock_time_t clock_time(void)
+{
+    return (clock_time_t)clock_time64();
+}   // clock_time
+
+
+
+/**
+ * Lock the clock against the other threads.
+ */
+uint32_t clock_arch_lock(void)
+{
+    pthread_mutex_lock( &lock );
+    return 0;
+}   // clock_arch_lock
+
+
+
+/**
+ * Release the lock of the clock.
+ */
+void clock_arch_unlock(uint32_t state)
+{
+    (void)state;
+    pthread_mutex_unlock( &lock );
+}   // clock_arch_unlock
+
+
+
+#if CLOCK_CONF_ADJUST
+/**
+ * Get the clock time with 64 bit without the corrections, the lock is held.
+ */
+clock_time64_t clock_time64_raw(void)
+{
+    return clock_conv_ticks( &conv, time_us_64() );
+}   // clock_time64_raw
+#endif
+
+
+
+/**
+ * Get the current clock time with 64 bit.
+ */
+clock_time64_t clock_time64(void)
+{
+    uint32_t state = clock_arch_lock();
+#if CLOCK_CONF_ADJUST
+    clock_time64_t ticks = clock_adjusted( clock_time64_raw() );
+#else
+    clock_time64_t ticks = clock_conv_ticks( &conv, time_us_64() );
+#endif
+
+    clock_arch_unlock( state );
+    return ticks;
+}   // clock_time64
+
+
+
+/**
+ * Get the seconds since the start of the clock.
+ */
+uint32_t clock_seconds(void)
+{
+    uint32_t state = clock_arch_lock();
+    uint32_t seconds = clock_conv_seconds( &conv_sec, time_us_64() );
+
+    clock_arch_unlock( state );
+    return seconds;
+}   // clock_seconds
+
+
+
+/**
+ * Get a free running microsecond counter.
+ */
+uint32_t clock_usecs(void)
+{
+    return (uint32_t)time_us_64();
+}   // clock_usecs
+
+
+
+/**
+ * Called with the next wake-up time, the host loop polls instead.
+ */
+void clock_update( clock_time_t next_event )
+{
+    (void)next_event;
+}   // clock_update
+
+
+
+void clock_start( void )
+{
+}   // clock_start
+
+#endif
@@ -0,0 +1,86 @@
+#if !defined(ARDUINO)
+
+#include <assert.h>
+#include <stdio.h>
+#include "sys/hibernate.h"
+
+//
+// Host stand-in for retained memory: the snapshot is kept in a file.
+// The executable must be linked with -no-pie, otherwise the addresses
+// in the snapshot differ from run to run.
+//
+
+#ifndef HIBERNATE_CONF_FILE
+#define HIBERNATE_CONF_FILE   "hibernate.bin"
+#endif
+
+
+
+/**
+ * Write the snapshot to the file.
+ */
+int16_t hibernate_port_write( const void *buf, uint16_t len )
+{
+    FILE *f = fopen( HIBERNATE_CONF_FILE, "wb" );
+    int16_t ok;
+
+    if (f == NULL) {
+        return 0;
+    }
+    ok = fwrite( buf, 1, len, f ) == len;
+    return fclose( f ) == 0  &&  ok;
+}   // hibernate_port_write
+
+
+
+/**
+ * Read the snapshot from the file.
+ */
+uint16_t hibernate_port_read( void *buf, uint16_t size )
+{
+    FILE *f = fopen( HIBERNATE_CONF_FILE, "rb" );
+    size_t len;
+
+    if (f == NULL) {
+        return 0;
+    }
+    len = fread( buf, 1, size, f );
+    fclose( f );
+    return (uint16_t)len;
+}   // hibernate_port_read
+
+
+
+/**
+ * Remove the file.
+ */
+void hibernate_port_clear( void )
+{
+    remove( HIBERNATE_CONF_FILE );
+}   // hibernate_port_clear
+
+
+
+/**
+ * FNV-1a hash of the executable, computed once.
+ */
+uint32_t hibernate_port_build_id( void )
+{
+    static uint32_t id;
+
+    if (id == 0) {
+        FILE *f = fopen( "/proc/self/exe", "rb" );
+        uint32_t h = 2166136261u;
+        int c;
+
+        assert( f != NULL );
+        while ((c = getc( f )) != EOF) {
+            h = (h ^ (uint8_t)c) * 16777619u;
+        }
+        fclose( f );
+        id = h | 1;
+    }
+    return id;
+}   // hibernate_port_build_id
+
+#endif
@@ -0,0 +1,129 @@
+#if !defined(ARDUINO)
+
+#include <pthread.h>
+#include <time.h>
+#include "sys/rtimer.h"
+
+//
+// Host stand-in for the hardware alarm: a thread sleeps until the
+// deadline and then plays the alarm interrupt.  "Interrupts" are locked
+// out with a recursive mutex which the thread holds while it calls
+// rtimer_run_next(), so the callbacks see the same exclusion as on a
+// CPU.  The lateness in rtimer_stats is the wake-up jitter of the host.
+//
+
+static pthread_mutex_t irq_lock;
+static pthread_mutex_t alarm_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t alarm_cond;
+static rtimer_clock_t alarm_time;
+static int alarm_armed;
+static int started;
+
+
+
+static struct timespec to_timespec( rtimer_clock_t time )
+/**
+ * Absolute CLOCK_MONOTONIC time of the rtimer deadline \a time.
+ */
+{
+    struct timespec ts;
+    int32_t delta = (int32_t)(time - rtimer_arch_now());
+    int64_t ns;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    ns = ts.tv_nsec + 1000LL * (delta > 0 ? delta : 0);
+    ts.tv_sec += ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    return ts;
+}   // to_timespec
+
+
+
+static void *alarm_thread( void *arg )
+{
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock( &alarm_lock );
+        while ( !alarm_armed) {
+            pthread_cond_wait( &alarm_cond, &alarm_lock );
+        }
+        if (RTIMER_CLOCK_LT(rtimer_arch_now(), alarm_time)) {
+            struct timespec ts = to_timespec( alarm_time );
+
+            // woken early by a new deadline or the timeout, check again
+            pthread_cond_timedwait( &alarm_cond, &alarm_lock, &ts );
+            pthread_mutex_unlock( &alarm_lock );
+            continue;
+        }
+        alarm_armed = 0;
+        pthread_mutex_unlock( &alarm_lock );
+
+        pthread_mutex_lock( &irq_lock );
+        rtimer_run_next();
+        pthread_mutex_unlock( &irq_lock );
+    }
+    return NULL;
+}   // alarm_thread
+
+
+
+/**
+ * Start the alarm thread.
+ */
+void rtimer_arch_init( void )
+{
+    if ( !started) {
+        pthread_mutexattr_t ma;
+        pthread_condattr_t ca;
+        pthread_t thread;
+
+        pthread_mutexattr_init( &ma );
+        pthread_mutexattr_settype( &ma, PTHREAD_MUTEX_RECURSIVE );
+        pthread_mutex_init( &irq_lock, &ma );
+        pthread_condattr_init( &ca );
+        pthread_condattr_setclock( &ca, CLOCK_MONOTONIC );
+        pthread_cond_init( &alarm_cond, &ca );
+        pthread_create( &thread, NULL, alarm_thread, NULL );
+        pthread_detach( thread );
+        started = 1;
+    }
+}   // rtimer_arch_init
+
+
+
+rtimer_clock_t rtimer_arch_now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (rtimer_clock_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}   // rtimer_arch_now
+
+
+
+void rtimer_arch_schedule( rtimer_clock_t time )
+{
+    pthread_mutex_lock( &alarm_lock );
+    alarm_time = time;
+    alarm_armed = 1;
+    pthread_cond_signal( &alarm_cond );
+    pthread_mutex_unlock( &alarm_lock );
+}   // rtimer_arch_schedule
+
+
+
+uint32_t rtimer_arch_lock( void )
+{
+    pthread_mutex_lock( &irq_lock );
+    return 0;
+}   // rtimer_arch_lock
+
+
+
+void rtimer_arch_unlock( uint32_t state )
+{
+    (void)state;
+    pthread_mutex_unlock( &irq_lock );
+}   // rtimer_arch_unlock
+
+#endif
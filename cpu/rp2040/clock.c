@@ -1,9 +1,18 @@
 #if defined(ARDUINO_ARCH_RP2040)
 
 #include <hardware/timer.h>
+#include <hardware/sync.h>
 #include "contiki.h"
 
 
+/* microseconds of the timer to clock ticks and to seconds */
+static struct clock_conv conv;
+static struct clock_conv_sec conv_sec;
+
+/* guards conv and the corrections of the clock, also against the other core */
+#define CLOCK_SPINLOCK  spin_lock_instance( PICO_SPINLOCK_ID_OS1 )
+
+
 
 /**
  * Get the current clock time.
@@ -14,12 +23,85 @@
  */
 clock_time_t clock_time(void)
 {
-    uint64_t time_us = time_us_64();
-    return (clock_time_t)((CLOCK_SECOND * time_us) / 1000000);
+    return (clock_time_t)clock_time64();
 }   // clock_time
 
 
 
+/**
+ * Lock the clock against interrupts and the other core.
+ */
+uint32_t clock_arch_lock(void)
+{
+    return spin_lock_blocking( CLOCK_SPINLOCK );
+}   // clock_arch_lock
+
+
+
+/**
+ * Release the lock of the clock.
+ */
+void clock_arch_unlock(uint32_t state)
+{
+    spin_unlock( CLOCK_SPINLOCK, state );
+}   // clock_arch_unlock
+
+
+
+#if CLOCK_CONF_ADJUST
+/**
+ * Get the clock time with 64 bit without the corrections, the lock is held.
+ */
+clock_time64_t clock_time64_raw(void)
+{
+    return clock_conv_ticks( &conv, time_us_64() );
+}   // clock_time64_raw
+#endif
+
+
+
+/**
+ * Get the current clock time with 64 bit.
+ */
+clock_time64_t clock_time64(void)
+{
+    uint32_t state = clock_arch_lock();
+#if CLOCK_CONF_ADJUST
+    clock_time64_t ticks = clock_adjusted( clock_time64_raw() );
+#else
+    clock_time64_t ticks = clock_conv_ticks( &conv, time_us_64() );
+#endif
+
+    clock_arch_unlock( state );
+    return ticks;
+}   // clock_time64
+
+
+
+/**
+ * Get the seconds since the start of the clock.
+ */
+uint32_t clock_seconds(void)
+{
+    uint32_t state = clock_arch_lock();
+    uint32_t seconds = clock_conv_seconds( &conv_sec, time_us_64() );
+
+    clock_arch_unlock( state );
+    return seconds;
+}   // clock_seconds
+
+
+
+/**
+ * Get a free running microsecond counter.
+ */
+uint32_t clock_usecs(void)
+{
+    return time_us_32();
+}   // clock_usecs
+
+
+
 /**
  * Initialize the interrupt system for the next etimer event.
  */
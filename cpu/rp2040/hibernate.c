@@ -0,0 +1,79 @@
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <string.h>
+#include <pico/platform.h>
+#include "sys/hibernate.h"
+
+//
+// The snapshot is kept in RAM which is not initialized by the runtime,
+// it survives dormant mode and watchdog resets.
+//
+
+static uint8_t __uninitialized_ram( snapshot )[HIBERNATE_CONF_SIZE];
+static uint16_t __uninitialized_ram( snapshot_len );
+static uint16_t __uninitialized_ram( snapshot_valid );
+
+#define SNAPSHOT_VALID  0xa55a
+
+/* bounds of the image in flash, from the linker script */
+extern const uint8_t __flash_binary_start[];
+extern const uint8_t __flash_binary_end[];
+
+
+
+/**
+ * Copy the snapshot to retained RAM.
+ */
+int16_t hibernate_port_write( const void *buf, uint16_t len )
+{
+    if (len > sizeof(snapshot)) {
+        return 0;
+    }
+    memcpy( snapshot, buf, len );
+    snapshot_len   = len;
+    snapshot_valid = SNAPSHOT_VALID;
+    return 1;
+}   // hibernate_port_write
+
+
+
+/**
+ * Copy the snapshot from retained RAM.
+ */
+uint16_t hibernate_port_read( void *buf, uint16_t size )
+{
+    if (snapshot_valid != SNAPSHOT_VALID  ||  snapshot_len > size) {
+        return 0;
+    }
+    memcpy( buf, snapshot, snapshot_len );
+    return snapshot_len;
+}   // hibernate_port_read
+
+
+
+void hibernate_port_clear( void )
+{
+    snapshot_valid = 0;
+}   // hibernate_port_clear
+
+
+
+/**
+ * FNV-1a hash of the image in flash, computed once.
+ */
+uint32_t hibernate_port_build_id( void )
+{
+    static uint32_t id;
+
+    if (id == 0) {
+        uint32_t h = 2166136261u;
+
+        for (const uint8_t *p = __flash_binary_start;  p < __flash_binary_end;  ++p) {
+            h = (h ^ *p) * 16777619u;
+        }
+        id = h | 1;
+    }
+    return id;
+}   // hibernate_port_build_id
+
+#endif
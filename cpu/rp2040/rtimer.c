@@ -0,0 +1,72 @@
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include <hardware/timer.h>
+#include <hardware/sync.h>
+#include "contiki.h"
+
+//
+// Real-time timers on one of the four alarms of the RP2040 timer.  The
+// alarm compares the lower 32 bit of the microsecond counter, which is
+// rtimer_clock_t directly.
+//
+
+static int alarm_num = -1;
+
+
+
+static void alarm_isr( uint alarm )
+{
+    (void)alarm;
+    rtimer_run_next();
+}   // alarm_isr
+
+
+
+/**
+ * Claim an unused hardware alarm.
+ */
+void rtimer_arch_init( void )
+{
+    if (alarm_num < 0) {
+        alarm_num = hardware_alarm_claim_unused( true );
+        hardware_alarm_set_callback( alarm_num, alarm_isr );
+    }
+}   // rtimer_arch_init
+
+
+
+rtimer_clock_t rtimer_arch_now( void )
+{
+    return time_us_32();
+}   // rtimer_arch_now
+
+
+
+/**
+ * Program the alarm, a missed deadline raises the interrupt immediately.
+ */
+void rtimer_arch_schedule( rtimer_clock_t time )
+{
+    uint64_t now = time_us_64();
+    int32_t delta = (int32_t)(time - (uint32_t)now);
+
+    if (hardware_alarm_set_target( alarm_num, from_us_since_boot(now + (delta > 0 ? delta : 0)) )) {
+        hardware_alarm_force_irq( alarm_num );
+    }
+}   // rtimer_arch_schedule
+
+
+
+uint32_t rtimer_arch_lock( void )
+{
+    return save_and_disable_interrupts();
+}   // rtimer_arch_lock
+
+
+
+void rtimer_arch_unlock( uint32_t state )
+{
+    restore_interrupts( state );
+}   // rtimer_arch_unlock
+
+#endif
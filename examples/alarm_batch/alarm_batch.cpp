@@ -0,0 +1,87 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Demonstration of the batched re-arming of the clock alarm.  A protocol
+// like process restarts several timeouts whenever one of them expires.
+// With ETIMER_CONF_DEFERRED_UPDATE each etimer_set() only marks the
+// wake-up time as stale and process_run() calls clock_update() once for
+// the round, without it every etimer_set() and every expiry pass
+// recomputes the wake-up time and reprograms the alarm.
+// Reported every RUN_SECONDS: timer events handled, calls of
+// clock_update() and queue changes merged into a later call.
+// clock_update() does not program an alarm yet on any port, the example
+// counts the calls of the core, which do not depend on the port.  With
+// the host clock (cpu/host/clock.c) the counts are about 500 per 5 s with
+// batching and 3000 without.
+//
+
+#define NUM_TIMEOUTS    5
+#define RUN_SECONDS     5
+
+static struct etimer timeouts[NUM_TIMEOUTS];
+static uint32_t handled;
+
+
+
+PROCESS( Protocol, "Protocol" );
+
+PROCESS_THREAD( Protocol, ev, data )
+/**
+ * Restarts all timeouts whenever one of them expires.
+ */
+{
+    PROCESS_BEGIN();
+
+    for (uint8_t i = 0;  i < NUM_TIMEOUTS;  ++i) {
+        etimer_set( &timeouts[i], MS_TO_CLOCK_SECOND(10 + 7 * i) );
+    }
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_TIMER );
+        ++handled;
+        for (uint8_t i = 0;  i < NUM_TIMEOUTS;  ++i) {
+            etimer_set( &timeouts[i], MS_TO_CLOCK_SECOND(10 + 7 * i) );
+        }
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Protocol )
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Protocol, NULL );
+
+    Serial.println( ETIMER_CONF_DEFERRED_UPDATE ? "alarm re-armed once per round" : "alarm re-armed on every change" );
+}   // setup
+
+
+
+void loop()
+{
+    static uint32_t last = millis();
+
+    while (process_run() != 0) {
+    }
+
+    if (millis() - last >= RUN_SECONDS * 1000UL) {
+        last = millis();
+
+        Serial.print( "timer events: " );
+        Serial.print( handled );
+        Serial.print( "  clock_update() calls: " );
+        Serial.print( etimer_alarm_updates() );
+        Serial.print( "  saved: " );
+        Serial.println( etimer_alarm_updates_saved() );
+        handled = 0;
+        etimer_stats_reset();
+    }
+}   // loop
@@ -0,0 +1,179 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Benchmark: cost of the conversion of a microsecond counter to clock
+// ticks and of clock_time().  Compared are
+// - direct: us * CLOCK_SECOND / 10^6 with 64 bit multiply and divide,
+//           the former clock_time() of the RP2040
+// - conv:   clock_conv_ticks(), 32 bit step with fractional accumulator
+// - clock_time(): the port, including the read of the hardware counter
+// - ms direct / ms conv: MS_TO_CLOCK_SECOND() of a variable with 64 bit
+//           division resp. with clock_ms_to_ticks()
+// Reported per call in [ns] and in CPU cycles.  The cycles come from
+// F_CPU on the targets and from the time stamp counter on an x86 host.
+// The conversions are checked against the 64 bit formulas, also
+// clock_conv_seconds().
+//
+
+#define BENCH_LOOPS     20000UL
+#define BENCH_STEP_US   37
+
+#if defined(__x86_64__)  ||  defined(__i386__)
+    #include <x86intrin.h>
+    #define CYCLES()    ((uint32_t)__rdtsc())
+#endif
+
+static volatile clock_time64_t sink64;
+static volatile uint32_t sink32;
+
+
+
+static void report( const char *title, uint32_t us, uint32_t cycles )
+{
+    Serial.print( title );
+    Serial.print( " [ns]: " );
+    Serial.print( (uint32_t)((1000ULL * us) / BENCH_LOOPS) );
+#if defined(CYCLES)
+    Serial.print( "  [cycles]: " );
+    Serial.print( cycles / BENCH_LOOPS );
+#elif defined(F_CPU)
+    (void)cycles;
+    Serial.print( "  [cycles]: " );
+    Serial.print( (uint32_t)(((uint64_t)us * (F_CPU / 1000000)) / BENCH_LOOPS) );
+#else
+    (void)cycles;
+#endif
+    Serial.println();
+}   // report
+
+
+
+#if defined(CYCLES)
+    #define BENCH_START()   uint32_t us = micros();  uint32_t cy = CYCLES()
+    #define BENCH_END(T)    cy = CYCLES() - cy;  us = micros() - us;  report( T, us, cy )
+#else
+    #define BENCH_START()   uint32_t us = micros()
+    #define BENCH_END(T)    us = micros() - us;  report( T, us, 0 )
+#endif
+
+
+
+static void bench_direct( void )
+{
+    uint64_t t_us = 1000000;
+
+    BENCH_START();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        t_us += BENCH_STEP_US;
+        sink64 = (CLOCK_SECOND * t_us) / 1000000;
+    }
+    BENCH_END( "direct" );
+}   // bench_direct
+
+
+
+static void bench_conv( void )
+{
+    struct clock_conv c = {};
+    uint64_t t_us = 1000000;
+
+    BENCH_START();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        t_us += BENCH_STEP_US;
+        sink64 = clock_conv_ticks( &c, t_us );
+    }
+    BENCH_END( "conv" );
+}   // bench_conv
+
+
+
+static void bench_ms_direct( void )
+{
+    BENCH_START();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = (clock_time_t)(((uint64_t)(n * BENCH_STEP_US) * CLOCK_MS_NUM + CLOCK_MS_DEN/2) / CLOCK_MS_DEN);
+    }
+    BENCH_END( "ms direct" );
+}   // bench_ms_direct
+
+
+
+static void bench_ms_conv( void )
+{
+    BENCH_START();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = MS_TO_CLOCK_SECOND( n * BENCH_STEP_US );
+    }
+    BENCH_END( "ms conv" );
+}   // bench_ms_conv
+
+
+
+static void bench_clock_time( void )
+{
+    BENCH_START();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = clock_time();
+    }
+    BENCH_END( "clock_time()" );
+}   // bench_clock_time
+
+
+
+static void check( void )
+/**
+ * The conversions over steps of various lengths, including a long pause.
+ */
+{
+    struct clock_conv c = {};
+    struct clock_conv_sec s = {};
+    uint64_t t_us = 0;
+    uint32_t mismatches = 0;
+
+    for (uint32_t n = 0;  n < 100000;  ++n) {
+        t_us += (n % 1000 == 999) ? 5000000000ULL : (n * 7919) % 3001;
+        if (clock_conv_ticks( &c, t_us ) != (CLOCK_SECOND * t_us) / 1000000) {
+            ++mismatches;
+        }
+        if (clock_conv_seconds( &s, t_us ) != t_us / 1000000) {
+            ++mismatches;
+        }
+        if (clock_ms_to_ticks( (uint32_t)t_us ) != (clock_time_t)(((uint64_t)(uint32_t)t_us * CLOCK_MS_NUM + CLOCK_MS_DEN/2) / CLOCK_MS_DEN)) {
+            ++mismatches;
+        }
+    }
+    Serial.print( "mismatches: " );
+    Serial.println( mismatches );
+}   // check
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+
+    Serial.print( "CLOCK_SECOND " );
+    Serial.print( (uint32_t)CLOCK_SECOND );
+    Serial.print( ", ticks = us * " );
+    Serial.print( (uint32_t)CLOCK_US_NUM );
+    Serial.print( " / " );
+    Serial.println( (uint32_t)CLOCK_US_DEN );
+
+    check();
+    bench_direct();
+    bench_conv();
+    bench_ms_direct();
+    bench_ms_conv();
+    bench_clock_time();
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
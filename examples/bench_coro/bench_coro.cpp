@@ -0,0 +1,121 @@
+#include <Arduino.h>
+#include "contiki.h"
+#include "sys/process-coro.h"
+
+//
+// Benchmark: resume cost and RAM per process of protothread processes
+// (lc-switch or lc-addrlabels, depending on the build environment) versus
+// coroutine processes.
+//
+
+#define BENCH_LOOPS   100000UL
+
+static uint32_t pt_counter;
+static uint32_t coro_counter;
+
+PROCESS( BenchPt, "BenchPt" );
+
+
+
+PROCESS_THREAD( BenchPt, ev, data )
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_YIELD();
+        ++pt_counter;
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( BenchPt )
+
+
+
+CORO_PROCESS( BenchCoro, "BenchCoro" )
+{
+    for (;;) {
+        co_await ctx.wait_event();
+        ++coro_counter;
+    }
+}   // CORO_PROCESS( BenchCoro )
+
+
+
+static uint32_t bench_synch( struct process *p )
+/**
+ * Resume \a p BENCH_LOOPS times via process_post_synch(), return [ns] per resume.
+ */
+{
+    uint32_t start = micros();
+
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        process_post_synch( p, PROCESS_EVENT_CONTINUE, NULL );
+    }
+    return (uint32_t)((1000ULL * (micros() - start)) / BENCH_LOOPS);
+}   // bench_synch
+
+
+
+static uint32_t bench_queued( struct process *p )
+/**
+ * Resume \a p BENCH_LOOPS times via process_post() and process_run(), return [ns] per resume.
+ */
+{
+    uint32_t start = micros();
+
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        process_post( p, PROCESS_EVENT_CONTINUE, NULL );
+        process_run();
+    }
+    return (uint32_t)((1000ULL * (micros() - start)) / BENCH_LOOPS);
+}   // bench_queued
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+
+    process_start( &BenchPt, NULL );
+    process_start( &BenchCoro, NULL );
+
+#if defined(__LC_ADDRLABELS_H__)
+    Serial.println( "protothreads: lc-addrlabels" );
+#else
+    Serial.println( "protothreads: lc-switch" );
+#endif
+
+    Serial.print( "protothread RAM per process [bytes]: " );
+    Serial.println( sizeof(struct process) );
+    Serial.print( "coroutine RAM per process [bytes]:   " );
+    Serial.print( sizeof(struct process) + sizeof(coro_state) + CORO_CONF_FRAME_SIZE );
+    Serial.print( " (frame used " );
+    Serial.print( coro_arena_max_frame() );
+    Serial.print( " of " );
+    Serial.print( CORO_CONF_FRAME_SIZE );
+    Serial.println( ")" );
+
+    Serial.print( "protothread resume, synch [ns]:  " );
+    Serial.println( bench_synch( &BenchPt ) );
+    Serial.print( "coroutine resume, synch [ns]:    " );
+    Serial.println( bench_synch( &BenchCoro ) );
+    Serial.print( "protothread resume, queued [ns]: " );
+    Serial.println( bench_queued( &BenchPt ) );
+    Serial.print( "coroutine resume, queued [ns]:   " );
+    Serial.println( bench_queued( &BenchCoro ) );
+
+    if (pt_counter != 2 * BENCH_LOOPS  ||  coro_counter != 2 * BENCH_LOOPS) {
+        Serial.println( "ERROR: missed resumes" );
+    }
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
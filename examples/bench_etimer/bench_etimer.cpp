@@ -0,0 +1,196 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Benchmark: cost of the etimer queue backends (ETIMER_CONF_BACKEND) for
+// 10 up to BENCH_MAX_TIMERS armed timers.  Reported per timer:
+// - set:    etimer_set() of an idle timer, random intervals
+// - rearm:  etimer_set() of an armed timer
+// - stop:   etimer_stop() of an armed timer
+// - expire: etimer_process work plus delivery of PROCESS_EVENT_TIMER,
+//           the timers expire spread over a window of at least 200 ticks
+//           with one poll per tick, polls without expiry are included
+// Timers are accessed in random order.
+// On the host with cpu/host/clock.c, 10000 timers and PROCESS_CONF_NUMEVENTS
+// 1024, set / rearm / stop / expire in [ns]: list 67700 / 98800 / 21800 /
+// 510, heap 240 / 170 / 50 / 840, wheel 180 / 150 / 20 / 500.
+//
+
+#ifndef BENCH_MAX_TIMERS
+#define BENCH_MAX_TIMERS    1000
+#endif
+
+#if ETIMER_CONF_BACKEND == ETIMER_BACKEND_HEAP  &&  ETIMER_CONF_HEAP_SIZE < BENCH_MAX_TIMERS
+    #error "ETIMER_CONF_HEAP_SIZE must be at least BENCH_MAX_TIMERS"
+#endif
+
+static struct etimer timers[BENCH_MAX_TIMERS];
+static uint16_t order[BENCH_MAX_TIMERS];
+static uint32_t fired;
+static uint32_t rnd_state = 1;
+
+
+
+PROCESS( Sink, "Sink" );
+
+PROCESS_THREAD( Sink, ev, data )
+/**
+ * Owner of the timers, counts the expired ones.
+ */
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_TIMER );
+        ++fired;
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Sink )
+
+
+
+static uint32_t rnd( void )
+{
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}   // rnd
+
+
+
+static void shuffle( uint16_t n )
+/**
+ * Random permutation of the first \a n timers in order[].
+ */
+{
+    for (uint16_t i = 0;  i < n;  ++i) {
+        order[i] = i;
+    }
+    for (uint16_t i = n - 1;  i > 0;  --i) {
+        uint16_t j = rnd() % (i + 1);
+        uint16_t t = order[i];
+
+        order[i] = order[j];
+        order[j] = t;
+    }
+}   // shuffle
+
+
+
+static uint32_t bench_set( uint16_t n )
+/**
+ * Arm \a n timers which do not expire during the benchmark, return [ns] per timer.
+ */
+{
+    uint32_t start;
+
+    shuffle( n );
+    PROCESS_CONTEXT_BEGIN( &Sink );
+    start = micros();
+    for (uint16_t i = 0;  i < n;  ++i) {
+        etimer_set( &timers[order[i]], MS_TO_CLOCK_SECOND(600000) + rnd() % MS_TO_CLOCK_SECOND(600000) );
+    }
+    start = micros() - start;
+    PROCESS_CONTEXT_END( &Sink );
+    return (uint32_t)((1000ULL * start) / n);
+}   // bench_set
+
+
+
+static uint32_t bench_stop( uint16_t n )
+/**
+ * Stop \a n armed timers, return [ns] per timer.
+ */
+{
+    uint32_t start;
+
+    shuffle( n );
+    start = micros();
+    for (uint16_t i = 0;  i < n;  ++i) {
+        etimer_stop( &timers[order[i]] );
+    }
+    return (uint32_t)((1000ULL * (micros() - start)) / n);
+}   // bench_stop
+
+
+
+static uint32_t bench_expire( uint16_t n, uint32_t set_ns )
+/**
+ * Let \a n timers expire, return [ns] per timer.  \a set_ns is used to
+ * start the expiry window after all timers are armed.
+ */
+{
+    clock_time_t window = (n / 8 < 200) ? 200 : n / 8;
+    clock_time_t offset = 10 + MS_TO_CLOCK_SECOND( 2 * ((uint64_t)set_ns * n / 1000000) );
+    uint32_t busy = 0;
+
+    shuffle( n );
+    PROCESS_CONTEXT_BEGIN( &Sink );
+    for (uint16_t i = 0;  i < n;  ++i) {
+        etimer_set( &timers[order[i]], offset + ((uint32_t)order[i] * window) / n );
+    }
+    PROCESS_CONTEXT_END( &Sink );
+
+    fired = 0;
+    while (fired < n) {
+        clock_time_t now = clock_time();
+        uint32_t start = micros();
+
+        process_poll( &etimer_process );
+        while (process_run() != 0) {
+        }
+        busy += micros() - start;
+
+        while (clock_time() == now) {
+        }
+    }
+    return (uint32_t)((1000ULL * busy) / n);
+}   // bench_expire
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Sink, NULL );
+
+    Serial.print( "etimer backend: " );
+    Serial.println( (ETIMER_CONF_BACKEND == ETIMER_BACKEND_HEAP) ? "binary heap" :
+                    (ETIMER_CONF_BACKEND == ETIMER_BACKEND_WHEEL) ? "timing wheel" : "sorted list" );
+    Serial.print( "struct etimer [bytes]: " );
+    Serial.print( sizeof(struct etimer) );
+    Serial.print( ", queue [bytes]: " );
+    Serial.println( sizeof(struct etimer_queue) );
+    Serial.println( "timers, set, rearm, stop, expire [ns/timer]" );
+
+    for (uint32_t n = 10;  n <= BENCH_MAX_TIMERS;  n *= 10) {
+        uint32_t set_ns = bench_set( n );
+        uint32_t rearm_ns = bench_set( n );
+        uint32_t stop_ns = bench_stop( n );
+        uint32_t expire_ns = bench_expire( n, set_ns );
+
+        Serial.print( n );
+        Serial.print( ", " );
+        Serial.print( set_ns );
+        Serial.print( ", " );
+        Serial.print( rearm_ns );
+        Serial.print( ", " );
+        Serial.print( stop_ns );
+        Serial.print( ", " );
+        Serial.println( expire_ns );
+    }
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
@@ -0,0 +1,112 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Benchmark: memory and speed of the event queue with the default slot
+// layout versus PROCESS_CONF_COMPACT_EVENTS.  Bursts of events are posted
+// round robin to some receivers and dispatched, the cost is reported per
+// event including the post.
+// On a 64 bit host with cpu/host/clock.c the slot shrinks from 24 to 10
+// bytes.  Both layouts take 15-30 ns per event, the difference is within
+// the noise of the host.
+//
+
+#define BENCH_EVENTS    20000UL
+#define NUM_RECEIVERS   4
+#define BURST           16
+
+static uint32_t received;
+
+
+
+PROCESS( Receiver0, "Receiver0" );
+PROCESS( Receiver1, "Receiver1" );
+PROCESS( Receiver2, "Receiver2" );
+PROCESS( Receiver3, "Receiver3" );
+
+static struct process *const receivers[NUM_RECEIVERS] = {
+    &Receiver0, &Receiver1, &Receiver2, &Receiver3
+};
+
+
+
+static char receiver_thread( struct pt *process_pt, process_event_t ev, process_data_t data )
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_CONTINUE );
+        received += (data != NULL);
+    }
+
+    PROCESS_END();
+}   // receiver_thread
+
+PROCESS_THREAD( Receiver0, ev, data ) { return receiver_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Receiver1, ev, data ) { return receiver_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Receiver2, ev, data ) { return receiver_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Receiver3, ev, data ) { return receiver_thread( process_pt, ev, data ); }
+
+
+
+static uint32_t bench_events( void )
+/**
+ * Post and dispatch BENCH_EVENTS events, return [ns] per event.
+ */
+{
+    uint32_t start;
+
+    received = 0;
+    start = micros();
+    for (uint32_t n = 0;  n < BENCH_EVENTS;  n += BURST) {
+        for (uint16_t k = 0;  k < BURST;  ++k) {
+            process_post( receivers[k % NUM_RECEIVERS], PROCESS_EVENT_CONTINUE, &received );
+        }
+        while (process_run() != 0) {
+        }
+    }
+    return (uint32_t)((1000ULL * (micros() - start)) / BENCH_EVENTS);
+}   // bench_events
+
+
+
+void setup()
+{
+    uint32_t ns;
+
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    for (uint16_t n = 0;  n < NUM_RECEIVERS;  ++n) {
+        process_start( receivers[n], NULL );
+    }
+
+    Serial.println( PROCESS_CONF_COMPACT_EVENTS ? "compact event slots" : "default event slots" );
+    Serial.print( "slot [bytes]: " );
+    Serial.print( sizeof(struct process_event_slot) );
+    Serial.print( ", queue of " );
+    Serial.print( PROCESS_CONF_NUMEVENTS );
+    Serial.print( " slots [bytes]: " );
+    Serial.println( PROCESS_CONF_NUMEVENTS * sizeof(struct process_event_slot) );
+#if PROCESS_CONF_COMPACT_EVENTS
+    Serial.print( "process table [bytes]: " );
+    Serial.println( sizeof(PROCESS_CTX->table) );
+#endif
+    Serial.print( "struct process [bytes]: " );
+    Serial.println( sizeof(struct process) );
+
+    ns = bench_events();
+    Serial.print( "post + dispatch [ns/event]: " );
+    Serial.print( ns );
+    Serial.print( ", received " );
+    Serial.println( received );
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
@@ -0,0 +1,200 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Benchmark: per loop overhead and timer to process latency of the etimer
+// expiry detection.  With ETIMER_CONF_SCHEDULER_EXPIRY process_run()
+// compares the next expiration time with the clock, without it the loop
+// polls etimer_process, which is dispatched and checks the timer queue.
+// Reported:
+// - idle loop: one loop iteration while a timer is armed but not due
+// - latency:   from the start of the first loop iteration at or after the
+//              deadline until the owner handles PROCESS_EVENT_TIMER,
+//              min / avg / max over BENCH_SAMPLES timers
+// - busy:      the same while another process is always runnable, so
+//              the loop calls process_run() once per iteration
+// On the host with cpu/host/clock.c an idle iteration costs 55-70 ns,
+// polled 90-95 ns.  The latencies are below the 1 us resolution apart
+// from the scheduling noise of the host.
+//
+
+#define BENCH_LOOPS     20000UL
+#define BENCH_SAMPLES   200
+
+static struct etimer timer;
+static uint32_t delivered_us;
+static bool delivered;
+static bool busy_on;
+
+
+
+PROCESS( Sink, "Sink" );
+PROCESS( Busy, "Busy" );
+
+PROCESS_THREAD( Sink, ev, data )
+/**
+ * Owner of the timer, takes the time of the delivery.
+ */
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_TIMER );
+        delivered_us = micros();
+        delivered = true;
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Sink )
+
+
+
+PROCESS_THREAD( Busy, ev, data )
+/**
+ * Always runnable until busy_on is cleared.
+ */
+{
+    PROCESS_BEGIN();
+
+    while (busy_on) {
+        PROCESS_PAUSE();
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Busy )
+
+
+
+static void loop_idle( void )
+/**
+ * Body of a main loop which runs until there is nothing left to do.
+ */
+{
+#if !ETIMER_CONF_SCHEDULER_EXPIRY
+    process_poll( &etimer_process );
+#endif
+    while (process_run() != 0) {
+    }
+}   // loop_idle
+
+
+
+static void loop_busy( void )
+/**
+ * Body of a main loop which runs one event per iteration.
+ */
+{
+#if !ETIMER_CONF_SCHEDULER_EXPIRY
+    process_poll( &etimer_process );
+#endif
+    process_run();
+}   // loop_busy
+
+
+
+static uint32_t bench_loop( void )
+/**
+ * Idle loop iterations with an armed timer, return [ns] per iteration.
+ */
+{
+    uint32_t start;
+
+    PROCESS_CONTEXT_BEGIN( &Sink );
+    etimer_set( &timer, MS_TO_CLOCK_SECOND(60000) );
+    PROCESS_CONTEXT_END( &Sink );
+    loop_idle();
+
+    start = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        loop_idle();
+    }
+    start = micros() - start;
+
+    etimer_stop( &timer );
+    return (uint32_t)((1000ULL * start) / BENCH_LOOPS);
+}   // bench_loop
+
+
+
+static void bench_latency( void (*body)(void), const char *title )
+/**
+ * Timer to process latency with the loop \a body.
+ */
+{
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint32_t sum = 0;
+
+    for (uint16_t s = 0;  s < BENCH_SAMPLES;  ) {
+        clock_time_t deadline;
+
+        PROCESS_CONTEXT_BEGIN( &Sink );
+        etimer_set( &timer, 2 + s % 3 );
+        PROCESS_CONTEXT_END( &Sink );
+        deadline = etimer_expiration_time( &timer );
+        delivered = false;
+
+        for (;;) {
+            uint32_t start = micros();
+            bool due = !CLOCK_A_LT_B( clock_time(), deadline );
+
+            body();
+            if (delivered) {
+                // a deadline passed during the iteration gives no sample
+                if (due) {
+                    uint32_t us = delivered_us - start;
+
+                    min = (us < min) ? us : min;
+                    max = (us > max) ? us : max;
+                    sum += us;
+                    ++s;
+                }
+                break;
+            }
+        }
+    }
+
+    Serial.print( title );
+    Serial.print( " latency min / avg / max [us]: " );
+    Serial.print( min );
+    Serial.print( " / " );
+    Serial.print( sum / BENCH_SAMPLES );
+    Serial.print( " / " );
+    Serial.println( max );
+}   // bench_latency
+
+
+
+void setup()
+{
+    uint32_t ns;
+
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Sink, NULL );
+
+    Serial.println( ETIMER_CONF_SCHEDULER_EXPIRY ? "expiry checked by process_run()" : "expiry checked by polled etimer_process" );
+
+    ns = bench_loop();
+    Serial.print( "idle loop [ns]: " );
+    Serial.println( ns );
+
+    bench_latency( loop_idle, "idle" );
+
+    busy_on = true;
+    process_start( &Busy, NULL );
+    bench_latency( loop_busy, "busy" );
+    busy_on = false;
+    loop_idle();
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
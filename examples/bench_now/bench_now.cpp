@@ -0,0 +1,92 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Clock reads of one etimer expiry pass.  N timers are armed, the clock
+// passes their deadline and one process_run() round delivers them.
+// Counted are the process_now() calls of that round which read the clock
+// and those answered from the snapshot of the round.  With
+// PROCESS_CONF_NOW_SNAPSHOT the pass reads the clock once, without it
+// every expiry check reads the clock.
+//
+
+#define MAX_TIMERS      16      // each delivery takes an event queue slot
+
+static struct etimer timers[MAX_TIMERS];
+
+
+
+PROCESS( Owner, "Owner" );
+
+PROCESS_THREAD( Owner, ev, data )
+/**
+ * Owner of the timers, takes the events.
+ */
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_WAIT_EVENT();
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Owner )
+
+
+
+static void bench_pass( uint16_t n )
+{
+    uint32_t reads, saved;
+
+    PROCESS_CONTEXT_BEGIN( &Owner );
+    for (uint16_t i = 0;  i < n;  ++i) {
+        etimer_set( &timers[i], 1 + i % 2 );
+    }
+    PROCESS_CONTEXT_END( &Owner );
+    delay( 5 );
+
+    reads = process_clock_reads();
+    saved = process_clock_reads_saved();
+    process_run();
+    reads = process_clock_reads() - reads;
+    saved = process_clock_reads_saved() - saved;
+
+    while (process_run() != 0) {
+    }
+
+    Serial.print( "timers: " );
+    Serial.print( n );
+    Serial.print( "  clock reads: " );
+    Serial.print( reads );
+    Serial.print( "  from snapshot: " );
+    Serial.println( saved );
+}   // bench_pass
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Owner, NULL );
+    while (process_run() != 0) {
+    }
+
+    Serial.println( PROCESS_CONF_NOW_SNAPSHOT ? "clock snapshot per round" : "clock read per check" );
+    for (uint16_t n = 1;  n <= MAX_TIMERS;  n *= 4) {
+        bench_pass( n );
+    }
+}   // setup
+
+
+
+void loop()
+{
+    while (process_run() != 0) {
+    }
+    delay( 1000 );
+}   // loop
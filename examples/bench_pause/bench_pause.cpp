@@ -0,0 +1,105 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Benchmark: cost of PROCESS_PAUSE() with the queue of runnable processes
+// versus self posted PROCESS_EVENT_CONTINUE (PROCESS_CONF_PAUSE_QUEUE=0).
+// Reports also the maximum number of occupied event queue slots.
+//
+
+#define BENCH_PAUSES    10000UL
+#define NUM_PAUSERS     8
+
+static uint32_t pauses;
+
+
+
+PROCESS( Pauser0, "Pauser0" );
+PROCESS( Pauser1, "Pauser1" );
+PROCESS( Pauser2, "Pauser2" );
+PROCESS( Pauser3, "Pauser3" );
+PROCESS( Pauser4, "Pauser4" );
+PROCESS( Pauser5, "Pauser5" );
+PROCESS( Pauser6, "Pauser6" );
+PROCESS( Pauser7, "Pauser7" );
+
+static struct process *const pausers[NUM_PAUSERS] = {
+    &Pauser0, &Pauser1, &Pauser2, &Pauser3, &Pauser4, &Pauser5, &Pauser6, &Pauser7
+};
+
+
+
+static char pauser_thread( struct pt *process_pt, process_event_t ev, process_data_t data )
+/**
+ * Common body of the pausers: pause until BENCH_PAUSES pauses are done in total.
+ */
+{
+    PROCESS_BEGIN();
+
+    while (pauses < BENCH_PAUSES) {
+        ++pauses;
+        PROCESS_PAUSE();
+    }
+
+    PROCESS_END();
+}   // pauser_thread
+
+PROCESS_THREAD( Pauser0, ev, data ) { return pauser_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Pauser1, ev, data ) { return pauser_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Pauser2, ev, data ) { return pauser_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Pauser3, ev, data ) { return pauser_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Pauser4, ev, data ) { return pauser_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Pauser5, ev, data ) { return pauser_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Pauser6, ev, data ) { return pauser_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Pauser7, ev, data ) { return pauser_thread( process_pt, ev, data ); }
+
+
+
+static uint32_t bench_pause( uint16_t num )
+/**
+ * Run \a num pausing processes until BENCH_PAUSES pauses are done, return [ns] per pause.
+ */
+{
+    uint32_t start;
+
+    pauses = 0;
+    process_stats_reset();
+    start = micros();
+    for (uint16_t n = 0;  n < num;  ++n) {
+        process_start( pausers[n], NULL );
+    }
+    while (process_run() != 0) {
+    }
+    return (uint32_t)((1000ULL * (micros() - start)) / BENCH_PAUSES);
+}   // bench_pause
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+
+    Serial.print( "PROCESS_PAUSE() via " );
+    Serial.println( PROCESS_PAUSE_QUEUE ? "runnable queue" : "self posted event" );
+
+    for (uint16_t num = 1;  num <= NUM_PAUSERS;  num *= 2) {
+        uint32_t ns = bench_pause( num );
+
+        Serial.print( num );
+        Serial.print( " processes [ns/pause]: " );
+        Serial.print( ns );
+        Serial.print( ", max queued events " );
+        Serial.println( process_maxevents() );
+    }
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
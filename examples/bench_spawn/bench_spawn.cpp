@@ -0,0 +1,139 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Benchmark: resume cost of nested child protothreads, PROCESS_PT_SPAWN()
+// versus PROCESS_SPAWN_CHILD() at nesting depths 1..8.
+// Build with PROCESS_CONF_CHILDREN=1.
+//
+
+#define BENCH_RESUMES   10000UL
+#define MAX_DEPTH       8
+
+static uint32_t resumes;
+static uint8_t depth;
+
+
+
+static struct pt spawn_pts[MAX_DEPTH];
+
+static PT_THREAD( nested_pt( struct pt *pt, uint8_t level ) )
+/**
+ * Spawn the next level with PT_SPAWN(), the innermost level pauses.
+ */
+{
+    PT_BEGIN( pt );
+
+    if (level < depth) {
+        PT_SPAWN( pt, &spawn_pts[level], nested_pt( &spawn_pts[level], level + 1 ) );
+    }
+    else {
+        while (resumes < BENCH_RESUMES) {
+            ++resumes;
+            process_pause();
+            PT_YIELD( pt );
+        }
+    }
+
+    PT_END( pt );
+}   // nested_pt
+
+
+
+static struct process_child children[MAX_DEPTH];
+
+PROCESS_CHILD_THREAD( nested_child, ev, data )
+/**
+ * Spawn the next level with PROCESS_SPAWN_CHILD(), the innermost level pauses.
+ */
+{
+    uint8_t level = (uint8_t)(uintptr_t)PROCESS_CHILD_ARG();
+
+    PROCESS_BEGIN();
+
+    if (level < depth) {
+        PROCESS_SPAWN_CHILD( &children[level], nested_child, (void *)(uintptr_t)(level + 1) );
+    }
+    else {
+        while (resumes < BENCH_RESUMES) {
+            ++resumes;
+            PROCESS_PAUSE();
+        }
+    }
+
+    PROCESS_END();
+}   // nested_child
+
+
+
+PROCESS( Spawner, "Spawner" );
+
+PROCESS_THREAD( Spawner, ev, data )
+{
+    static struct pt child_pt;
+
+    PROCESS_BEGIN();
+
+    PROCESS_PT_SPAWN( &child_pt, nested_pt( &child_pt, 1 ) );
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Spawner )
+
+
+
+PROCESS( ChildSpawner, "ChildSpawner" );
+
+PROCESS_THREAD( ChildSpawner, ev, data )
+{
+    static struct process_child child;
+
+    PROCESS_BEGIN();
+
+    PROCESS_SPAWN_CHILD( &child, nested_child, (void *)1 );
+
+    PROCESS_END();
+}   // PROCESS_THREAD( ChildSpawner )
+
+
+
+static uint32_t bench( struct process *p )
+/**
+ * Run \a p until BENCH_RESUMES resumes of the innermost level are done, return [ns] per resume.
+ */
+{
+    uint32_t start;
+
+    resumes = 0;
+    start = micros();
+    process_start( p, NULL );
+    while (process_run() != 0) {
+    }
+    return (uint32_t)((1000ULL * (micros() - start)) / BENCH_RESUMES);
+}   // bench
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+
+    Serial.println( "depth: PROCESS_PT_SPAWN() [ns/resume], PROCESS_SPAWN_CHILD() [ns/resume]" );
+    for (depth = 1;  depth <= MAX_DEPTH;  ++depth) {
+        Serial.print( depth );
+        Serial.print( ": " );
+        Serial.print( bench( &Spawner ) );
+        Serial.print( ", " );
+        Serial.println( bench( &ChildSpawner ) );
+    }
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
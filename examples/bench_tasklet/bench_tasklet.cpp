@@ -0,0 +1,121 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Benchmark: throughput of deferred function calls via tasklets versus
+// ctimers with zero timeout.
+//
+
+#define BENCH_LOOPS   10000UL
+
+static uint32_t calls;
+static struct ctimer ctimer;
+
+
+
+static void callback( void *para )
+{
+    ++calls;
+}   // callback
+
+
+
+static void run_all( void )
+{
+    process_poll( &etimer_process );
+    while (process_run() != 0) {
+    }
+}   // run_all
+
+
+
+static uint32_t bench_ctimer( void )
+/**
+ * Defer BENCH_LOOPS calls via ctimer_set() with zero timeout, return [ns] per call.
+ */
+{
+    uint32_t start = micros();
+
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        ctimer_set( &ctimer, 0, callback, NULL );
+        run_all();
+    }
+    return (uint32_t)((1000ULL * (micros() - start)) / BENCH_LOOPS);
+}   // bench_ctimer
+
+
+
+static uint32_t bench_tasklet( void )
+/**
+ * Defer BENCH_LOOPS calls via tasklet_schedule(), return [ns] per call.
+ */
+{
+    uint32_t start = micros();
+
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        tasklet_schedule( callback, NULL );
+        run_all();
+    }
+    return (uint32_t)((1000ULL * (micros() - start)) / BENCH_LOOPS);
+}   // bench_tasklet
+
+
+
+static uint32_t bench_tasklet_batch( void )
+/**
+ * Defer BENCH_LOOPS calls via tasklet_schedule() in batches of TASKLET_CONF_NUM, return [ns] per call.
+ */
+{
+    uint32_t start = micros();
+
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  n += TASKLET_CONF_NUM) {
+        for (uint32_t b = 0;  b < TASKLET_CONF_NUM;  ++b) {
+            tasklet_schedule( callback, NULL );
+        }
+        run_all();
+    }
+    return (uint32_t)((1000ULL * (micros() - start)) / BENCH_LOOPS);
+}   // bench_tasklet_batch
+
+
+
+void setup()
+{
+    uint32_t ns;
+
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    ctimer_init();
+    process_start( &etimer_process, NULL );
+
+    calls = 0;
+    ns = bench_ctimer();
+    Serial.print( "ctimer, zero timeout [ns/call]: " );
+    Serial.print( ns );
+    Serial.print( ", calls " );
+    Serial.println( calls );
+
+    calls = 0;
+    ns = bench_tasklet();
+    Serial.print( "tasklet [ns/call]:              " );
+    Serial.print( ns );
+    Serial.print( ", calls " );
+    Serial.println( calls );
+
+    calls = 0;
+    ns = bench_tasklet_batch();
+    Serial.print( "tasklet, batched [ns/call]:     " );
+    Serial.print( ns );
+    Serial.print( ", calls " );
+    Serial.println( calls );
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
@@ -0,0 +1,197 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Benchmark: cost of the 64 bit clock and timers against the 32 bit path.
+// Reported in [ns] per call:
+// - clock:   clock_time() / clock_time64() / clock_seconds()
+// - compare: CLOCK_A_LT_B() / CLOCK64_A_LT_B() of values loaded from memory
+// - expired: timer_expired() / timer64_expired() / stimer_expired()
+// - etimer:  etimer_set() + etimer_stop() / etimer64_set() + etimer64_stop()
+//
+
+#define BENCH_LOOPS     20000UL
+
+static volatile uint32_t sink32;
+static volatile uint64_t sink64;
+static volatile clock_time_t a32, b32;
+static volatile clock_time64_t a64, b64;
+
+static struct timer t32;
+static struct timer64 t64;
+static struct stimer ts;
+static struct etimer et32;
+static struct etimer64 et64;
+
+
+
+PROCESS( Owner, "Owner" );
+
+PROCESS_THREAD( Owner, ev, data )
+/**
+ * Owner of the event timers, never woken because the timers are stopped.
+ */
+{
+    PROCESS_BEGIN();
+    PROCESS_WAIT_EVENT_UNTIL( 0 );
+    PROCESS_END();
+}   // PROCESS_THREAD( Owner )
+
+
+
+static void report( const char *title, uint32_t us32, uint32_t us64, int32_t us_s = -1 )
+/**
+ * Print the time per call of the 32 bit / 64 bit (/ seconds) variant.
+ */
+{
+    Serial.print( title );
+    Serial.print( " [ns] 32bit / 64bit" );
+    if (us_s >= 0) {
+        Serial.print( " / seconds" );
+    }
+    Serial.print( ": " );
+    Serial.print( (uint32_t)((1000ULL * us32) / BENCH_LOOPS) );
+    Serial.print( " / " );
+    Serial.print( (uint32_t)((1000ULL * us64) / BENCH_LOOPS) );
+    if (us_s >= 0) {
+        Serial.print( " / " );
+        Serial.print( (uint32_t)((1000ULL * us_s) / BENCH_LOOPS) );
+    }
+    Serial.println();
+}   // report
+
+
+
+static void bench_clock( void )
+{
+    uint32_t us32, us64, uss;
+
+    us32 = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = clock_time();
+    }
+    us32 = micros() - us32;
+
+    us64 = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink64 = clock_time64();
+    }
+    us64 = micros() - us64;
+
+    uss = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = clock_seconds();
+    }
+    uss = micros() - uss;
+
+    report( "clock", us32, us64, uss );
+}   // bench_clock
+
+
+
+static void bench_compare( void )
+{
+    uint32_t us32, us64;
+
+    a32 = 1;  b32 = 2;
+    a64 = 1;  b64 = 2;
+
+    us32 = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = CLOCK_A_LT_B( a32, b32 );
+    }
+    us32 = micros() - us32;
+
+    us64 = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = CLOCK64_A_LT_B( a64, b64 );
+    }
+    us64 = micros() - us64;
+
+    report( "compare", us32, us64 );
+}   // bench_compare
+
+
+
+static void bench_expired( void )
+{
+    uint32_t us32, us64, uss;
+
+    timer_set( &t32, MS_TO_CLOCK_SECOND(60000) );
+    timer64_set( &t64, MS_TO_CLOCK_SECOND(60000) );
+    stimer_set( &ts, 60 );
+
+    us32 = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = timer_expired( &t32 );
+    }
+    us32 = micros() - us32;
+
+    us64 = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = timer64_expired( &t64 );
+    }
+    us64 = micros() - us64;
+
+    uss = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        sink32 = stimer_expired( &ts );
+    }
+    uss = micros() - uss;
+
+    report( "expired", us32, us64, uss );
+}   // bench_expired
+
+
+
+static void bench_etimer( void )
+{
+    uint32_t us32, us64;
+
+    PROCESS_CONTEXT_BEGIN( &Owner );
+
+    us32 = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        etimer_set( &et32, MS_TO_CLOCK_SECOND(60000) );
+        etimer_stop( &et32 );
+    }
+    us32 = micros() - us32;
+
+    us64 = micros();
+    for (uint32_t n = 0;  n < BENCH_LOOPS;  ++n) {
+        etimer64_set( &et64, MS_TO_CLOCK_SECOND(60000) );
+        etimer64_stop( &et64 );
+    }
+    us64 = micros() - us64;
+
+    PROCESS_CONTEXT_END( &Owner );
+
+    report( "etimer set+stop", us32, us64 );
+}   // bench_etimer
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Owner, NULL );
+
+    bench_clock();
+    bench_compare();
+    bench_expired();
+    bench_etimer();
+}   // setup
+
+
+
+void loop()
+{
+    while (process_run() != 0) {
+    }
+    delay( 1000 );
+}   // loop
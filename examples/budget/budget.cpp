@@ -0,0 +1,122 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Dispatch time budget demo: a process filtering a large buffer yields
+// only when its budget is used up, so the blinking LED keeps its timing.
+// Build with PROCESS_CONF_BUDGET=1.
+//
+
+#define NUM_SAMPLES  4096
+
+PROCESS( Filter, "Filter" );
+PROCESS( Blink, "Blink" );
+PROCESS( Statistics, "Statistics" );
+
+static int16_t samples[NUM_SAMPLES];
+
+
+
+PROCESS_THREAD( Filter, ev, data )
+{
+    static uint16_t i;
+    static int32_t avg;
+
+    PROCESS_BEGIN();
+
+    for (;;) {
+        for (i = 0;  i < NUM_SAMPLES;  ++i) {
+            samples[i] = (int16_t)random( -1000, 1000 );
+        }
+
+        // exponential moving average, one budget check per sample
+        avg = 0;
+        for (i = 0;  i < NUM_SAMPLES;  ++i) {
+            avg += (samples[i] - avg) / 16;
+            samples[i] = (int16_t)avg;
+            PROCESS_YIELD_IF_OVER_BUDGET();
+        }
+        PROCESS_PAUSE();
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Filter )
+
+
+
+PROCESS_THREAD( Blink, ev, data )
+{
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    pinMode( LED_BUILTIN, OUTPUT );
+    etimer_set( &timer, MS_TO_CLOCK_SECOND( 100 ) );
+    for (;;) {
+        PROCESS_WAIT_UNTIL( etimer_expired( &timer) );
+        etimer_reset( &timer );
+        digitalWrite( LED_BUILTIN, !digitalRead( LED_BUILTIN ) );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Blink )
+
+
+
+static void print_stats( struct process *p )
+{
+    Serial.print( PROCESS_NAME_STRING( p ) );
+    Serial.print( ": total " );
+    Serial.print( p->budget.total_us );
+    Serial.print( "[us], max " );
+    Serial.print( p->budget.max_us );
+    Serial.print( "[us], yields " );
+    Serial.print( p->budget.yields );
+    Serial.print( ", overruns " );
+    Serial.println( p->budget.overruns );
+}   // print_stats
+
+
+
+PROCESS_THREAD( Statistics, ev, data )
+{
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    etimer_set( &timer, MS_TO_CLOCK_SECOND( 5000 ) );
+    for (;;) {
+        PROCESS_WAIT_UNTIL( etimer_expired( &timer) );
+        etimer_reset( &timer );
+
+        print_stats( &Filter );
+        print_stats( &Blink );
+        print_stats( &Statistics );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Statistics )
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+
+    clock_start();
+    process_init();
+    process_set_budget( 200 );
+
+    process_start( &etimer_process, NULL );
+    process_start( &Statistics, NULL );
+    process_start( &Blink, NULL );
+    process_start( &Filter, NULL );
+}   // setup
+
+
+
+void loop()
+{
+    // Filter is always busy, expired etimers are delivered by each run
+    process_run();
+}   // loop
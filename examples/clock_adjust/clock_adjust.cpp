@@ -0,0 +1,94 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Correction of the clock with armed timers.  A periodic etimer ticks
+// every second and prints clock_time() and millis(), a one-shot etimer
+// is armed for ONESHOT_S seconds.  After 3 ticks the clock is stepped
+// forward by STEP_S seconds with clock_adjust(): clock_time() jumps, but
+// the ticks keep their distance in millis() and the one-shot fires in
+// time, no timer expires early.  After 8 ticks the clock is slewed by
+// SLEW_MS with clock_slew(): the ticks come slightly faster until the
+// correction is done, without a burst.  Built with
+// CLOCK_CONF_SLEW_SHIFT=4 the slew takes 16 times the correction.
+//
+
+#if !CLOCK_CONF_ADJUST
+    #error "build with -DCLOCK_CONF_ADJUST=1"
+#endif
+
+#define STEP_S          100
+#define SLEW_MS         250
+#define ONESHOT_S       6
+
+static struct etimer tick, oneshot;
+static uint32_t started;
+
+
+
+PROCESS( Ticker, "Ticker" );
+
+PROCESS_THREAD( Ticker, ev, data )
+/**
+ * Print the clock every second, correct it in between.
+ */
+{
+    static uint16_t n;
+
+    PROCESS_BEGIN();
+
+    started = millis();
+    etimer_set( &tick, CLOCK_SECOND );
+    etimer_set( &oneshot, ONESHOT_S * CLOCK_SECOND );
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_TIMER );
+        if (data == &oneshot) {
+            Serial.print( "one-shot after [ms]: " );
+            Serial.println( millis() - started );
+            continue;
+        }
+        etimer_reset( &tick );
+
+        Serial.print( "tick " );
+        Serial.print( ++n );
+        Serial.print( "  clock_time(): " );
+        Serial.print( clock_time() );
+        Serial.print( "  millis(): " );
+        Serial.print( millis() - started );
+        Serial.print( "  slew left: " );
+        Serial.println( clock_slew_remaining() );
+
+        if (n == 3) {
+            Serial.println( "step" );
+            clock_adjust( STEP_S * CLOCK_SECOND );
+        }
+        else if (n == 8) {
+            Serial.println( "slew" );
+            clock_slew( MS_TO_CLOCK_SECOND(SLEW_MS) );
+        }
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Ticker )
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Ticker, NULL );
+}   // setup
+
+
+
+void loop()
+{
+    while (process_run() != 0) {
+    }
+}   // loop
@@ -70,11 +70,9 @@ void setup()
 void loop() 
 {
     //
-    // this is the basic contiki scheduler:
-    // - poll etimer process so that it can check expired etimers
-    // - run waiting processes
+    // this is the basic contiki scheduler: run waiting processes,
+    // process_run() also delivers the expired etimers
     //
-    process_poll( &etimer_process );
     for (;;) {
         if (process_run() == 0) {
             break;
@@ -0,0 +1,131 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Demo: periodic etimers and their overrun policies.  Three processes
+// tick every 100ms with a different policy, another process blocks the
+// CPU for 350ms every 2s.  Every tick prints its time stamp; the skip and
+// report timers stay on the 100ms grid, the burst timer catches up.
+//
+
+PROCESS( Skip, "Skip" );
+PROCESS( Burst, "Burst" );
+PROCESS( Report, "Report" );
+PROCESS( Staller, "Staller" );
+
+
+
+static void print_tick( const char *name, const char *suffix, uint16_t overruns )
+{
+    Serial.print( name );
+    Serial.print( " @" );
+    Serial.print( (unsigned long)CLOCK_SECOND_TO_MS( clock_time() ));
+    Serial.print( suffix );
+    if (overruns != 0) {
+        Serial.print( ", overruns " );
+        Serial.print( overruns );
+    }
+    Serial.println();
+}   // print_tick
+
+
+
+PROCESS_THREAD( Skip, ev, data )
+{
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    etimer_set_periodic( &timer, MS_TO_CLOCK_SECOND( 100 ), ETIMER_PERIODIC_SKIP );
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_TIMER  &&  data == &timer );
+        print_tick( "skip", "", 0 );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Skip )
+
+
+
+PROCESS_THREAD( Burst, ev, data )
+{
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    etimer_set_periodic( &timer, MS_TO_CLOCK_SECOND( 100 ), ETIMER_PERIODIC_BURST );
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_TIMER  &&  data == &timer );
+        print_tick( "burst", "", 0 );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Burst )
+
+
+
+PROCESS_THREAD( Report, ev, data )
+{
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    // absolute deadlines: on full seconds plus n * 100ms
+    etimer_set_periodic_at( &timer, (clock_time() / CLOCK_SECOND + 1) * CLOCK_SECOND,
+                            MS_TO_CLOCK_SECOND( 100 ), ETIMER_PERIODIC_REPORT );
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_TIMER  &&  data == &timer );
+        print_tick( "report", "", etimer_overruns( &timer ));
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Report )
+
+
+
+PROCESS_THREAD( Staller, ev, data )
+/**
+ * Block the CPU for 350ms every 2s.
+ */
+{
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    etimer_set( &timer, MS_TO_CLOCK_SECOND( 2000 ) );
+    for (;;) {
+        PROCESS_WAIT_UNTIL( etimer_expired( &timer ) );
+        etimer_reset( &timer );
+
+        Serial.println( "stall 350ms" );
+        delay( 350 );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Staller )
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Skip, NULL );
+    process_start( &Burst, NULL );
+    process_start( &Report, NULL );
+    process_start( &Staller, NULL );
+}   // setup
+
+
+
+void loop()
+{
+    while (process_run() != 0) {
+    }
+
+    delay( 10 );
+}   // loop
@@ -0,0 +1,140 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Demo: timer slack.  Four low priority "sensors" with different periods
+// tolerate 200ms delay, a blinker needs exact timing.  loop() sleeps until
+// the next etimer wake-up like a tickless battery node would do and counts
+// the wake-ups.  Compare with ETIMER_CONF_SLACK=0.
+//
+
+#define NUM_SENSORS     4
+#define SENSOR_SLACK    MS_TO_CLOCK_SECOND( 200 )
+
+static const uint16_t sensor_period_ms[NUM_SENSORS] = { 1000, 1100, 1300, 1700 };
+static uint32_t loop_wakeups;
+static uint32_t samples;
+
+
+
+PROCESS( Sensors, "Sensors" );
+PROCESS( Blinker, "Blinker" );
+PROCESS( Report, "Report" );
+
+
+
+PROCESS_THREAD( Sensors, ev, data )
+/**
+ * Periodic sampling with slack, all sensors share the process.
+ */
+{
+    static struct etimer timers[NUM_SENSORS];
+
+    PROCESS_BEGIN();
+
+    for (uint16_t n = 0;  n < NUM_SENSORS;  ++n) {
+        etimer_set_slack( &timers[n], MS_TO_CLOCK_SECOND( sensor_period_ms[n] ), SENSOR_SLACK );
+    }
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_TIMER );
+
+        ++samples;
+        etimer_reset( (struct etimer *)data );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Sensors )
+
+
+
+PROCESS_THREAD( Blinker, ev, data )
+/**
+ * Tight timer without slack.
+ */
+{
+    static struct etimer timer;
+    static bool on;
+
+    PROCESS_BEGIN();
+
+    pinMode( LED_BUILTIN, OUTPUT );
+    etimer_set( &timer, MS_TO_CLOCK_SECOND( 250 ) );
+    for (;;) {
+        PROCESS_WAIT_UNTIL( etimer_expired( &timer ) );
+
+        on = !on;
+        digitalWrite( LED_BUILTIN, on );
+        etimer_reset( &timer );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Blinker )
+
+
+
+PROCESS_THREAD( Report, ev, data )
+/**
+ * Output the wake-up counters every 10s.
+ */
+{
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    etimer_set_slack( &timer, MS_TO_CLOCK_SECOND( 10000 ), MS_TO_CLOCK_SECOND( 1000 ) );
+    for (;;) {
+        PROCESS_WAIT_UNTIL( etimer_expired( &timer ) );
+        etimer_reset( &timer );
+
+        Serial.print( "samples: " );
+        Serial.print( samples );
+        Serial.print( ", loop wake-ups: " );
+        Serial.print( loop_wakeups );
+#if PROCESS_CONF_STATS
+        Serial.print( ", etimer wake-ups: " );
+        Serial.print( etimer_wakeups() );
+        Serial.print( ", saved: " );
+        Serial.print( etimer_wakeups_saved() );
+#endif
+        Serial.println();
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Report )
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Sensors, NULL );
+    process_start( &Blinker, NULL );
+    process_start( &Report, NULL );
+
+    Serial.println( ETIMER_CONF_SLACK ? "etimer slack enabled" : "etimer slack disabled" );
+}   // setup
+
+
+
+void loop()
+{
+    clock_time_t now;
+    clock_time_t next;
+
+    ++loop_wakeups;
+    while (process_run() != 0) {
+    }
+
+    // sleep until the next wake-up of the etimers
+    now = clock_time();
+    next = etimer_next_expiration_time();
+    if (etimer_pending()  &&  CLOCK_A_LT_B(now, next)) {
+        delay( CLOCK_SECOND_TO_MS( next - now ) );
+    }
+}   // loop
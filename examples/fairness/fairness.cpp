@@ -0,0 +1,118 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Fair dispatching demo: a hot process which keeps itself busy shares the
+// CPU with two background processes according to the process weights.
+// Build with PROCESS_CONF_FAIRNESS=1.
+//
+
+PROCESS( Hot, "Hot" );
+PROCESS( Background1, "Background1" );
+PROCESS( Background2, "Background2" );
+PROCESS( Statistics, "Statistics" );
+
+
+
+PROCESS_THREAD( Hot, ev, data )
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_PAUSE();
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Hot )
+
+
+
+PROCESS_THREAD( Background1, ev, data )
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_PAUSE();
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Background1 )
+
+
+
+PROCESS_THREAD( Background2, ev, data )
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        process_poll( PROCESS_CURRENT() );
+        PROCESS_YIELD_UNTIL( ev == PROCESS_EVENT_POLL );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Background2 )
+
+
+
+static void print_stats( struct process *p )
+{
+    Serial.print( PROCESS_NAME_STRING( p ) );
+    Serial.print( ": weight " );
+    Serial.print( p->fair.weight );
+    Serial.print( ", dispatches " );
+    Serial.print( p->fair.dispatches );
+    Serial.print( ", deferrals " );
+    Serial.print( p->fair.deferrals );
+    Serial.print( ", max starvation " );
+    Serial.print( CLOCK_SECOND_TO_MS( p->fair.max_starvation ) );
+    Serial.println( "[ms]" );
+}   // print_stats
+
+
+
+PROCESS_THREAD( Statistics, ev, data )
+{
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    etimer_set( &timer, MS_TO_CLOCK_SECOND( 5000 ) );
+    for (;;) {
+        PROCESS_WAIT_UNTIL( etimer_expired( &timer) );
+        etimer_reset( &timer );
+
+        Serial.print( "rounds: " );
+        Serial.println( process_fair_rounds() );
+        print_stats( &Hot );
+        print_stats( &Background1 );
+        print_stats( &Background2 );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Statistics )
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+
+    clock_start();
+    process_init();
+
+    process_start( &etimer_process, NULL );
+    process_start( &Statistics, NULL );
+    process_start( &Background1, NULL );
+    process_start( &Background2, NULL );
+    process_start( &Hot, NULL );
+
+    process_set_weight( &Hot, 4 );
+}   // setup
+
+
+
+void loop()
+{
+    // the processes are always busy, expired etimers are delivered by each run
+    process_run();
+}   // loop
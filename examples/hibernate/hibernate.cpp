@@ -0,0 +1,184 @@
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+#include "contiki.h"
+#include "sys/hibernate.h"
+
+//
+// Benchmark: time until the application is ready after a cold boot
+// versus after restoring a snapshot with hibernate_resume().
+//
+// The cold boot of the sensor process computes a calibration table and
+// waits for the sensor to warm up.  After resume the process continues
+// in its sampling loop with its etimer and the blink ctimer rebased.
+//
+// Deep sleep is simulated by re-initializing the scheduler, on a device
+// hibernate_suspend() would be followed by esp_deep_sleep() or the like
+// and boot() would be called from setup() with the sleep duration.
+//
+
+#define TABLE_SIZE      128
+#define WARMUP_MS       100
+#define SAMPLE_MS       20
+#define BLINK_MS        200
+#define SLEEP_MS        250
+#define NUM_CYCLES      3
+
+/* application state which survives hibernation */
+static struct {
+    uint16_t table[TABLE_SIZE];
+    uint32_t samples;
+    uint8_t ready;
+    uint8_t led;
+} state;
+
+static struct hibernate_region state_region = { NULL, &state, sizeof(state) };
+
+static struct ctimer blink;
+
+
+
+PROCESS( Sensor, "Sensor" );
+
+
+
+static void blink_cb( void *ptr )
+{
+    (void)ptr;
+    state.led = !state.led;
+    digitalWrite( LED_BUILTIN, state.led );
+    ctimer_reset( &blink );
+}   // blink_cb
+
+
+
+PROCESS_THREAD( Sensor, ev, data )
+/**
+ * Calibrate, warm up, then sample periodically.
+ */
+{
+    static struct etimer timer;
+
+    PROCESS_BEGIN();
+
+    // expensive part of the cold boot
+    for (uint16_t i = 0;  i < TABLE_SIZE;  ++i) {
+        float x = 0;
+
+        for (uint16_t k = 1;  k <= 200;  ++k) {
+            x += sqrtf( (float)(i * k) ) / (float)k;
+        }
+        state.table[i] = (uint16_t)x;
+    }
+    ctimer_set( &blink, MS_TO_CLOCK_SECOND( BLINK_MS ), blink_cb, NULL );
+
+    etimer_set( &timer, MS_TO_CLOCK_SECOND( WARMUP_MS ) );
+    PROCESS_WAIT_UNTIL( etimer_expired( &timer ) );
+    state.ready = 1;
+
+    etimer_set( &timer, MS_TO_CLOCK_SECOND( SAMPLE_MS ) );
+    for (;;) {
+        PROCESS_WAIT_UNTIL( etimer_expired( &timer ) );
+        etimer_reset( &timer );
+        ++state.samples;
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Sensor )
+
+
+
+static void run_once( void )
+{
+    while (process_run() != 0) {
+    }
+}   // run_once
+
+
+
+static void run( uint32_t ms )
+{
+    clock_time_t end = clock_time() + MS_TO_CLOCK_SECOND( ms );
+
+    while (CLOCK_A_LT_B( clock_time(), end )) {
+        run_once();
+    }
+}   // run
+
+
+
+static uint32_t boot( clock_time_t slept, int16_t *resumed )
+/**
+ * Initialize the scheduler and restore the snapshot or start the application,
+ * return [us] until the application is ready.
+ */
+{
+    uint32_t start = micros();
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    ctimer_init();
+    hibernate_add_region( &state_region );
+
+    *resumed = hibernate_resume( slept );
+    if ( !*resumed) {
+        memset( &state, 0, sizeof(state) );
+        process_start( &Sensor, NULL );
+        while ( !state.ready) {
+            run_once();
+        }
+    }
+    return micros() - start;
+}   // boot
+
+
+
+void setup()
+{
+    static uint8_t snapshot[HIBERNATE_CONF_SIZE];
+    int16_t resumed;
+    uint32_t us;
+
+    Serial.begin(115200);
+    delay( 2000 );
+    pinMode( LED_BUILTIN, OUTPUT );
+
+    us = boot( 0, &resumed );
+    Serial.print( "cold boot [us]: " );
+    Serial.println( us );
+
+    for (uint16_t n = 0;  n < NUM_CYCLES;  ++n) {
+        clock_time_t t;
+        uint32_t samples;
+
+        run( 300 );
+        samples = state.samples;
+        Serial.print( "samples: " );
+        Serial.print( samples );
+        Serial.print( ", snapshot [bytes]: " );
+        Serial.println( hibernate_save( snapshot, sizeof(snapshot) ) );
+        if ( !hibernate_suspend()) {
+            Serial.println( "hibernate_suspend() failed" );
+            return;
+        }
+
+        t = clock_time();
+        delay( SLEEP_MS );
+        us = boot( clock_time() - t, &resumed );
+        Serial.print( resumed ? "resume [us]: " : "no snapshot, cold boot [us]: " );
+        Serial.println( us );
+
+        // sampling must continue where it stopped
+        run( 100 );
+        Serial.print( "samples after resume: " );
+        Serial.println( state.samples - samples );
+    }
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
@@ -0,0 +1,150 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Boot time with process_start_lazy() (PROCESS_CONF_LAZY_START=1) versus
+// process_start().  The services have an expensive PROCESS_EVENT_INIT
+// (simulated hardware setup), but are needed only when a request is
+// posted to them.  The time from the start of setup() to the first
+// loop() is reported together with the time spent in PROCESS_EVENT_INIT.
+//
+
+#define NUM_SERVICES    6
+#define SERVICE_INIT_US 5000UL
+#define REQUEST_MS      1000
+
+static uint32_t boot_start;
+static uint8_t first_loop = 1;
+static uint16_t requests;
+
+
+
+PROCESS( Service0, "Service0" );
+PROCESS( Service1, "Service1" );
+PROCESS( Service2, "Service2" );
+PROCESS( Service3, "Service3" );
+PROCESS( Service4, "Service4" );
+PROCESS( Service5, "Service5" );
+PROCESS( Requester, "Requester" );
+
+static struct process *const services[NUM_SERVICES] = {
+    &Service0, &Service1, &Service2, &Service3, &Service4, &Service5
+};
+
+
+
+static char service_thread( struct pt *process_pt, process_event_t ev, process_data_t data )
+/**
+ * Common body of the services: expensive setup, then handle requests.
+ */
+{
+    PROCESS_BEGIN();
+
+    {
+        uint32_t start = micros();
+
+        while (micros() - start < SERVICE_INIT_US) {
+        }
+    }
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_CONTINUE );
+        ++requests;
+    }
+
+    PROCESS_END();
+}   // service_thread
+
+PROCESS_THREAD( Service0, ev, data ) { return service_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Service1, ev, data ) { return service_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Service2, ev, data ) { return service_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Service3, ev, data ) { return service_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Service4, ev, data ) { return service_thread( process_pt, ev, data ); }
+PROCESS_THREAD( Service5, ev, data ) { return service_thread( process_pt, ev, data ); }
+
+
+
+static void report( const char *when )
+{
+    Serial.print( when );
+    Serial.print( ": " );
+    Serial.print( requests );
+    Serial.print( " requests, " );
+    Serial.print( process_inits() );
+    Serial.print( " inits in " );
+    Serial.print( process_init_us() );
+#if PROCESS_CONF_LAZY_START
+    Serial.print( " [us], deferred " );
+    Serial.println( process_lazy_pending() );
+#else
+    Serial.println( " [us]" );
+#endif
+}   // report
+
+
+
+PROCESS_THREAD( Requester, ev, data )
+/**
+ * Send a request to the next service every REQUEST_MS.
+ */
+{
+    static struct etimer timer;
+    static uint16_t n;
+
+    PROCESS_BEGIN();
+
+    etimer_set( &timer, MS_TO_CLOCK_SECOND( REQUEST_MS ) );
+    for (n = 0;  n < NUM_SERVICES;  ++n) {
+        PROCESS_WAIT_UNTIL( etimer_expired( &timer ) );
+        etimer_reset( &timer );
+
+        process_post( services[n], PROCESS_EVENT_CONTINUE, NULL );
+        PROCESS_PAUSE();
+        report( "after request" );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Requester )
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    boot_start = micros();
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+
+    for (uint16_t n = 0;  n < NUM_SERVICES;  ++n) {
+#if PROCESS_CONF_LAZY_START
+        process_start_lazy( services[n], NULL );
+#else
+        process_start( services[n], NULL );
+#endif
+    }
+    process_start( &Requester, NULL );
+}   // setup
+
+
+
+void loop()
+{
+    if (first_loop) {
+        uint32_t us = micros() - boot_start;
+
+        first_loop = 0;
+        Serial.print( PROCESS_CONF_LAZY_START ? "lazy start" : "eager start" );
+        Serial.print( ", time to first loop [us]: " );
+        Serial.println( us );
+        report( "boot" );
+    }
+
+    while (process_run() != 0) {
+    }
+
+    delay( 10 );
+}   // loop
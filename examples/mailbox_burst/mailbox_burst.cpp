@@ -0,0 +1,139 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Test: timer bursts larger than a mailbox.  With PROCESS_CONF_MAILBOXES
+// the events of an expiring etimer go into the mailbox of its owner.
+// BURST_ETIMERS etimers of one process (mailbox of PROCESS_CONF_MAILBOX_SIZE
+// events) and BURST_CTIMERS ctimers (mailbox of ctimer_process with
+// PROCESS_CONF_SERVICE_MAILBOX_SIZE events) expire at the same tick.
+// Timers which find the mailbox full stay due until the owner has taken
+// an event.  Checked is that each timer is delivered exactly once and
+// with its own struct etimer resp. callback argument.
+//
+
+#if !PROCESS_CONF_MAILBOXES
+    #error "build with -DPROCESS_CONF_MAILBOXES=1"
+#endif
+
+#define BURST_ETIMERS   (3 * PROCESS_CONF_MAILBOX_SIZE)
+#define BURST_CTIMERS   (PROCESS_CONF_SERVICE_MAILBOX_SIZE + 4)
+#define ROUNDS          10
+
+static struct etimer etimers[BURST_ETIMERS];
+static struct ctimer ctimers[BURST_CTIMERS];
+static uint16_t etimer_hits[BURST_ETIMERS];
+static uint16_t ctimer_hits[BURST_CTIMERS];
+static uint16_t foreign;
+
+
+
+static void ctimer_hit( void *ptr )
+{
+    ++ctimer_hits[(struct ctimer *)ptr - ctimers];
+}   // ctimer_hit
+
+
+
+PROCESS( Owner, "Owner" );
+
+PROCESS_THREAD( Owner, ev, data )
+/**
+ * Owner of the etimers and the ctimers, counts the deliveries.
+ */
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_WAIT_EVENT();
+        if (ev == PROCESS_EVENT_TIMER) {
+            struct etimer *t = (struct etimer *)data;
+
+            if (t >= etimers  &&  t < etimers + BURST_ETIMERS) {
+                ++etimer_hits[t - etimers];
+            }
+            else {
+                ++foreign;
+            }
+        }
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Owner )
+
+
+
+static bool burst( void )
+{
+    bool ok;
+
+    for (uint16_t i = 0;  i < BURST_ETIMERS;  ++i) {
+        etimer_hits[i] = 0;
+    }
+    for (uint16_t i = 0;  i < BURST_CTIMERS;  ++i) {
+        ctimer_hits[i] = 0;
+    }
+    foreign = 0;
+
+    PROCESS_CONTEXT_BEGIN( &Owner );
+    for (uint16_t i = 0;  i < BURST_ETIMERS;  ++i) {
+        etimer_set( &etimers[i], 2 );
+    }
+    for (uint16_t i = 0;  i < BURST_CTIMERS;  ++i) {
+        ctimer_set( &ctimers[i], 2, ctimer_hit, &ctimers[i] );
+    }
+    PROCESS_CONTEXT_END( &Owner );
+
+    delay( 10 );
+    while (process_run() != 0) {
+    }
+
+    ok = (foreign == 0);
+    for (uint16_t i = 0;  i < BURST_ETIMERS;  ++i) {
+        ok = ok  &&  etimer_hits[i] == 1  &&  etimer_expired( &etimers[i] );
+    }
+    for (uint16_t i = 0;  i < BURST_CTIMERS;  ++i) {
+        ok = ok  &&  ctimer_hits[i] == 1  &&  ctimer_expired( &ctimers[i] );
+    }
+    return ok;
+}   // burst
+
+
+
+void setup()
+{
+    uint16_t passed = 0;
+
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    ctimer_init();
+    process_start( &Owner, NULL );
+    while (process_run() != 0) {
+    }
+
+    for (uint16_t r = 0;  r < ROUNDS;  ++r) {
+        passed += burst() ? 1 : 0;
+    }
+    Serial.print( "etimers: " );
+    Serial.print( BURST_ETIMERS );
+    Serial.print( "  ctimers: " );
+    Serial.print( BURST_CTIMERS );
+    Serial.print( "  bursts passed: " );
+    Serial.print( passed );
+    Serial.print( " / " );
+    Serial.println( ROUNDS );
+    Serial.println( (passed == ROUNDS) ? "OK" : "FAILED" );
+}   // setup
+
+
+
+void loop()
+{
+    while (process_run() != 0) {
+    }
+    delay( 1000 );
+}   // loop
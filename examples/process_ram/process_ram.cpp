@@ -0,0 +1,61 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Report the memory used per process for the selected configuration.
+// The mutable struct process is in RAM, the constant struct process_desc
+// (name and thread) and the name string are in flash.
+//
+
+PROCESS( Demo, "Demo" );
+
+
+
+PROCESS_THREAD( Demo, ev, data )
+{
+    PROCESS_BEGIN();
+    PROCESS_END();
+}   // PROCESS_THREAD( Demo )
+
+
+
+static void report( const char *what, unsigned size )
+{
+    Serial.print( what );
+    Serial.print( size );
+    Serial.println( " bytes" );
+}   // report
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &Demo, NULL );
+
+    report( "RAM   struct process:      ", sizeof(struct process) );
+    report( "        of which struct pt: ", sizeof(struct pt) );
+#if PROCESS_CONF_MAILBOXES
+    report( "        of which mailbox:   ", sizeof(struct process_mailbox) );
+#endif
+    report( "flash struct process_desc: ", sizeof(struct process_desc) );
+#if !PROCESS_CONF_NO_PROCESS_NAMES
+    report( "      name \"Demo\":         ", sizeof("Demo") );
+#endif
+    Serial.print( "processes per KByte RAM: " );
+    Serial.println( 1024 / sizeof(struct process) );
+    Serial.print( "name of the demo process: '" );
+    Serial.print( PROCESS_NAME_STRING( &Demo ) );
+    Serial.println( "'" );
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop
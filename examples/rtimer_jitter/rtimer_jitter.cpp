@@ -0,0 +1,102 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Jitter of the real-time timers.  A callback reschedules itself every
+// PERIOD_US microseconds, drift free from its previous deadline, and
+// takes the lateness of each call.  After SAMPLES calls a process is
+// polled from the callback and reports min / avg / max lateness and a
+// histogram.  On the host the alarm is a thread (cpu/host/rtimer.c), so
+// the numbers show the wake-up jitter of the host.
+//
+
+#define PERIOD_US       250
+#define SAMPLES         4000
+#define BUCKET_US       5
+#define BUCKETS         8
+
+static struct rtimer rt;
+static volatile uint16_t samples;
+static uint16_t histogram[BUCKETS];
+
+
+
+PROCESS( Report, "Report" );
+
+
+
+static void tick( struct rtimer *t, void *ptr )
+/**
+ * Called from the alarm interrupt.
+ */
+{
+    rtimer_clock_t late = RTIMER_NOW() - t->time;
+    uint16_t b = late / BUCKET_US;
+
+    (void)ptr;
+    ++histogram[(b < BUCKETS) ? b : BUCKETS - 1];
+    if (++samples < SAMPLES) {
+        rtimer_set( t, t->time + PERIOD_US, tick, NULL );
+    }
+    else {
+        process_poll( &Report );
+    }
+}   // tick
+
+
+
+PROCESS_THREAD( Report, ev, data )
+/**
+ * Print the lateness statistics of each run and start the next one.
+ */
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        samples = 0;
+        for (uint8_t b = 0;  b < BUCKETS;  ++b) {
+            histogram[b] = 0;
+        }
+        rtimer_stats_reset();
+        rtimer_set( &rt, RTIMER_NOW() + PERIOD_US, tick, NULL );
+
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_POLL );
+
+        Serial.print( "late [us] min / avg / max: " );
+        Serial.print( rtimer_stats.late_min );
+        Serial.print( " / " );
+        Serial.print( rtimer_stats.late_sum / rtimer_stats.runs );
+        Serial.print( " / " );
+        Serial.println( rtimer_stats.late_max );
+        for (uint8_t b = 0;  b < BUCKETS;  ++b) {
+            Serial.print( (b < BUCKETS - 1) ? "  <  " : "  >= " );
+            Serial.print( (b < BUCKETS - 1) ? (b + 1) * BUCKET_US : b * BUCKET_US );
+            Serial.print( "us: " );
+            Serial.println( histogram[b] );
+        }
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Report )
+
+
+
+void setup()
+{
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    rtimer_init();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Report, NULL );
+}   // setup
+
+
+
+void loop()
+{
+    while (process_run() != 0) {
+    }
+}   // loop
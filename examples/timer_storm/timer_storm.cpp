@@ -0,0 +1,156 @@
+#include <Arduino.h>
+#include "contiki.h"
+
+//
+// Benchmark: occupancy of the event queue during a timer storm, i.e. many
+// etimers expiring at the same tick, with and without
+// ETIMER_CONF_DIRECT_DELIVERY.  BACKGROUND events are queued for another
+// process when the storm hits.  Reported per storm size:
+// - queue:    peak number of used event queue slots
+// - expired:  peak number of expired timers awaiting delivery outside
+//             the queue (direct delivery only)
+// - dispatch: expiry pass plus delivery of PROCESS_EVENT_TIMER
+// Without direct delivery the storm must fit into the PROCESS_CONF_NUMEVENTS
+// slots of the queue, otherwise the overflow forces a restart.
+//
+
+#ifndef STORM_MAX_TIMERS
+#if ETIMER_CONF_DIRECT_DELIVERY
+#define STORM_MAX_TIMERS    256
+#else
+#define STORM_MAX_TIMERS    (PROCESS_CONF_NUMEVENTS - 8)
+#endif
+#endif
+
+#if ETIMER_CONF_BACKEND == ETIMER_BACKEND_HEAP  &&  ETIMER_CONF_HEAP_SIZE < STORM_MAX_TIMERS
+    #error "ETIMER_CONF_HEAP_SIZE must be at least STORM_MAX_TIMERS"
+#endif
+
+#define BACKGROUND          4
+
+static struct etimer timers[STORM_MAX_TIMERS];
+static uint32_t fired;
+static uint32_t background;
+
+
+
+PROCESS( Sink, "Sink" );
+PROCESS( Consumer, "Consumer" );
+
+PROCESS_THREAD( Sink, ev, data )
+/**
+ * Owner of the timers, counts the expired ones.
+ */
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_TIMER );
+        fired += etimer_expired( (struct etimer *)data );
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Sink )
+
+
+
+PROCESS_THREAD( Consumer, ev, data )
+/**
+ * Receiver of the background traffic.
+ */
+{
+    PROCESS_BEGIN();
+
+    for (;;) {
+        PROCESS_WAIT_EVENT_UNTIL( ev == PROCESS_EVENT_CONTINUE );
+        ++background;
+    }
+
+    PROCESS_END();
+}   // PROCESS_THREAD( Consumer )
+
+
+
+static uint32_t storm( uint16_t n )
+/**
+ * Let \a n timers expire at the same tick, return [ns] per timer.
+ */
+{
+    clock_time_t deadline;
+    uint32_t start;
+
+    PROCESS_CONTEXT_BEGIN( &Sink );
+    for (uint16_t i = 0;  i < n;  ++i) {
+        etimer_set( &timers[i], 10 );
+    }
+    PROCESS_CONTEXT_END( &Sink );
+    deadline = etimer_expiration_time( &timers[0] );
+
+    while (process_run() != 0) {
+    }
+    while (CLOCK_A_LT_B( clock_time(), deadline )) {
+    }
+
+    fired = background = 0;
+    process_stats_reset();
+    for (uint16_t k = 0;  k < BACKGROUND;  ++k) {
+        process_post( &Consumer, PROCESS_EVENT_CONTINUE, NULL );
+    }
+
+    start = micros();
+    process_poll( &etimer_process );
+    while (process_run() != 0) {
+    }
+    start = micros() - start;
+
+    if (fired != n  ||  background != BACKGROUND) {
+        Serial.println( "lost deliveries!" );
+    }
+    return (uint32_t)((1000ULL * start) / n);
+}   // storm
+
+
+
+void setup()
+{
+    static const uint16_t sizes[] = { 4, 8, 16, 24, 64, 256 };
+
+    Serial.begin(115200);
+    delay( 2000 );
+
+    clock_start();
+    process_init();
+    process_start( &etimer_process, NULL );
+    process_start( &Sink, NULL );
+    process_start( &Consumer, NULL );
+
+    Serial.println( ETIMER_CONF_DIRECT_DELIVERY ? "direct timer delivery" : "timer events through the event queue" );
+    Serial.print( "event queue [slots]: " );
+    Serial.print( PROCESS_CONF_NUMEVENTS );
+    Serial.print( ", struct etimer [bytes]: " );
+    Serial.println( sizeof(struct etimer) );
+    Serial.println( "timers, queue peak [slots], expired peak, dispatch [ns/timer]" );
+
+    for (uint16_t k = 0;  k < sizeof(sizes) / sizeof(sizes[0])  &&  sizes[k] <= STORM_MAX_TIMERS;  ++k) {
+        uint32_t ns = storm( sizes[k] );
+
+        Serial.print( sizes[k] );
+        Serial.print( ", " );
+        Serial.print( process_maxevents() );
+        Serial.print( ", " );
+#if ETIMER_CONF_DIRECT_DELIVERY
+        Serial.print( process_maxexpired() );
+#else
+        Serial.print( 0 );
+#endif
+        Serial.print( ", " );
+        Serial.println( ns );
+    }
+}   // setup
+
+
+
+void loop()
+{
+    delay( 1000 );
+}   // loop